@@ -0,0 +1,52 @@
+#define LB_NO_MAIN
+#include "../lb10/lb10/lb10.cpp"
+
+#include "harness.h"
+
+#include <cstdio>
+#include <random>
+
+int main(int argc, char** argv) {
+    bench::Runner runner(argc, argv);
+    const char* dataPath = "bench_lb10_data.txt";
+    std::mt19937 rng(42);
+
+    for (size_t size : { 100, 1000, 10000 }) {
+        AccessControlSystem<Resource> system;
+        for (size_t i = 0; i < size; ++i) {
+            system.addUser(std::make_unique<Student>("Student " + std::to_string(i), static_cast<int>(i), static_cast<int>(i % 5), 101));
+            system.addResource(Resource("Room " + std::to_string(i), static_cast<int>(i % 5)));
+        }
+
+        std::vector<std::pair<int, std::string>> queries;
+        for (int i = 0; i < 1000; ++i) {
+            queries.emplace_back(static_cast<int>(rng() % size), "Room " + std::to_string(rng() % size));
+        }
+
+        runner.run("AccessControlSystem::checkAccess", size, queries.size(), [&] {
+            size_t granted = 0;
+            for (const auto& query : queries) {
+                granted += system.checkAccess(query.first, query.second);
+            }
+            bench::doNotOptimize(&granted);
+        });
+    }
+
+    for (size_t size : { 1000, 10000, 100000 }) {
+        AccessControlSystem<Resource> system;
+        for (size_t i = 0; i < size; ++i) {
+            system.addUser(std::make_unique<Teacher>("Teacher " + std::to_string(i), static_cast<int>(i), 3, "Computer Science"));
+            system.addResource(Resource("Room " + std::to_string(i), 2));
+        }
+        system.saveToFile(dataPath);
+
+        runner.run("AccessControlSystem::loadFromFile", size, 2 * size, [&] {
+            AccessControlSystem<Resource> loaded;
+            loaded.loadFromFile(dataPath);
+            bench::doNotOptimize(&loaded);
+        });
+    }
+
+    std::remove(dataPath);
+    return runner.finish();
+}
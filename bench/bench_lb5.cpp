@@ -0,0 +1,25 @@
+#define LB_NO_MAIN
+#include "../lb5/lb5/lb5.cpp"
+
+#include "harness.h"
+
+int main(int argc, char** argv) {
+    bench::Runner runner(argc, argv);
+
+    for (size_t size : { 100, 1000, 10000 }) {
+        Queue<std::shared_ptr<Entity>> queue;
+        runner.run("Queue::popEntity", size, size,
+            [&] {
+                for (size_t i = 0; i < size; ++i) {
+                    queue.addEntity(std::make_shared<Player>("Hero", 100, 0));
+                }
+            },
+            [&] {
+                for (size_t i = 0; i < size; ++i) {
+                    queue.popEntity();
+                }
+            });
+    }
+
+    return runner.finish();
+}
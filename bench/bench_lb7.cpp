@@ -0,0 +1,43 @@
+#define LB_NO_MAIN
+#include "../lb7.1/lb7/lb7.cpp"
+
+#include "harness.h"
+
+#include <cstdio>
+
+int main(int argc, char** argv) {
+    bench::Runner runner(argc, argv);
+    const char* binaryPath = "bench_lb7_save.dat";
+    const char* textPath = "bench_lb7_save.txt";
+
+    for (size_t size : { 1000, 10000, 100000 }) {
+        GameManager<Entity> manager;
+        std::ofstream text(textPath);
+        for (size_t i = 0; i < size; ++i) {
+            std::string name = "Player" + std::to_string(i);
+            manager.addEntity(std::make_unique<Player>(name, 100, static_cast<int>(i % 50)));
+            text << name << " 100 " << i % 50 << "\n";
+        }
+        text.close();
+
+        runner.run("saveToFile", size, size, [&] {
+            saveToFile(manager, binaryPath);
+        });
+
+        runner.run("loadFromFile", size, size, [&] {
+            GameManager<Entity> loaded;
+            loadFromFile(loaded, binaryPath);
+            bench::doNotOptimize(&loaded);
+        });
+
+        runner.run("loadFromTextFile", size, size, [&] {
+            GameManager<Entity> loaded;
+            loadFromTextFile(loaded, textPath);
+            bench::doNotOptimize(&loaded);
+        });
+    }
+
+    std::remove(binaryPath);
+    std::remove(textPath);
+    return runner.finish();
+}
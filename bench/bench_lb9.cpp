@@ -0,0 +1,106 @@
+#define LB_NO_MAIN
+#include "../lb9/lb9/lb9.cpp"
+
+#include "harness.h"
+
+#include <cstdio>
+
+// Поток вывода, который ничего не пишет: attackEnemy печатает каждое сообщение в std::cout
+class NullBuffer : public std::streambuf {
+protected:
+    int overflow(int c) override { return c; }
+    std::streamsize xsputn(const char*, std::streamsize n) override { return n; }
+};
+
+int main(int argc, char** argv) {
+    bench::Runner runner(argc, argv);
+    const char* logPath = "bench_lb9_log.txt";
+
+    for (size_t size : { 10, 100, 1000 }) {
+        std::vector<std::string> names;
+        for (size_t i = 0; i < size; ++i) {
+            names.push_back("Potion " + std::to_string(i));
+        }
+
+        Inventory inventory;
+        Character target("Target", 1000000, 0, 0);
+        runner.run("Inventory::useItem", size, size,
+            [&] {
+                for (const auto& name : names) {
+                    inventory.addItem(std::make_unique<Potion>(name, 1));
+                }
+            },
+            [&] {
+                for (const auto& name : names) {
+                    inventory.useItem(name, target);
+                }
+            });
+    }
+
+    {
+        Logger<std::string> logger(logPath);
+        for (size_t size : { 16, 256 }) {
+            std::string message(size, 'x');
+            runner.run("Logger::log", size, 1000, [&] {
+                for (int i = 0; i < 1000; ++i) {
+                    logger.log(message);
+                }
+            });
+        }
+
+        // Каждый участник получает от 0 до 7 уровней, в лог пишется одна запись
+        for (size_t size : { 1000, 100000 }) {
+            std::vector<std::unique_ptr<Character>> raid;
+            std::vector<Character*> raiders;
+            std::vector<int> rewards;
+            for (size_t i = 0; i < size; ++i) {
+                raid.push_back(std::make_unique<Character>("Raider", 100, 10, 5));
+                raiders.push_back(raid.back().get());
+                rewards.push_back(static_cast<int>(100 * (i % 8)));
+            }
+            runner.run("awardExperience", size, size, [&] {
+                awardExperience(raiders, rewards, logger);
+            });
+        }
+
+        NullBuffer null;
+        Character hero("Hero", 100, 25, 5);
+        Monster dummy("Dummy", 1000000000, 0, 5);
+        runner.run("Entity::attackEnemy", 1, 1000, [&] {
+            std::streambuf* console = std::cout.rdbuf(&null);
+            for (int i = 0; i < 1000; ++i) {
+                hero.attackEnemy(dummy, logger);
+            }
+            std::cout.rdbuf(console);
+        });
+
+        // То же, но сообщения собираются в арене боя, которая сбрасывается после каждой серии ударов
+        arena::Arena combatArena;
+        runner.run("Entity::attackEnemy (arena)", 1, 1000, [&] {
+            std::streambuf* console = std::cout.rdbuf(&null);
+            {
+                arena::Scope battle(combatArena);
+                for (int i = 0; i < 1000; ++i) {
+                    hero.attackEnemy(dummy, logger);
+                }
+            }
+            std::cout.rdbuf(console);
+        });
+    }
+
+    // Бои не заканчиваются, поэтому каждый тик обрабатывает все size боёв
+    for (size_t size : { 1000, 100000 }) {
+        World world;
+        for (size_t i = 0; i < size; ++i) {
+            size_t hero = world.addCharacter(std::make_unique<Character>("Hero", 1000000000, 25, 15));
+            size_t skeleton = world.addMonster(std::make_unique<Skeleton>("Skeleton", 1000000000, 20, 8));
+            world.startEncounter(hero, skeleton);
+        }
+        runner.run("World::tick", size, 1, [&] {
+            world.tick();
+        });
+    }
+
+    std::remove(logPath);
+    return runner.finish();
+}
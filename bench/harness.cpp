@@ -0,0 +1,162 @@
+#include "harness.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <new>
+
+namespace {
+
+std::atomic<size_t> allocations{ 0 };
+std::atomic<size_t> bytes{ 0 };
+
+}
+
+// Подсчёт всех выделений памяти в программе бенчмарка
+void* operator new(size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    bytes.fetch_add(size, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, size_t) noexcept {
+    std::free(p);
+}
+
+namespace bench {
+
+size_t allocationCount() {
+    return allocations.load(std::memory_order_relaxed);
+}
+
+size_t allocatedBytes() {
+    return bytes.load(std::memory_order_relaxed);
+}
+
+void doNotOptimize(const void* value) {
+#if defined(__GNUC__) || defined(__clang__)
+    // Пустая вставка, которая "читает" указатель и всю память: компилятор обязан посчитать значение
+    asm volatile("" : : "g"(value) : "memory");
+#else
+    // Запись в volatile-указатель (а не в указатель на volatile) удалить нельзя
+    static const void* volatile sink;
+    sink = value;
+#endif
+}
+
+Runner::Runner(int argc, char** argv) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg.compare(0, 7, "--json=") == 0) {
+            jsonPath = arg.substr(7);
+        }
+        else if (arg.compare(0, 9, "--filter=") == 0) {
+            filter = arg.substr(9);
+        }
+        else if (arg.compare(0, 11, "--min-time=") == 0) {
+            minSeconds = std::atof(arg.c_str() + 11);
+        }
+        else {
+            std::cerr << "Unknown option: " << arg << std::endl;
+            std::exit(2);
+        }
+    }
+}
+
+void Runner::run(const std::string& name, size_t size, size_t ops, const std::function<void()>& body) {
+    run(name, size, ops, [] {}, body);
+}
+
+void Runner::run(const std::string& name, size_t size, size_t ops,
+    const std::function<void()>& setup, const std::function<void()>& body) {
+    if (!filter.empty() && name.find(filter) == std::string::npos) {
+        return;
+    }
+
+    const size_t maxIterations = 1000000;
+    double seconds = 0;
+    size_t iterations = 0;
+    size_t allocationTotal = 0;
+    size_t byteTotal = 0;
+
+    while (iterations == 0 || (seconds < minSeconds && iterations < maxIterations)) {
+        setup();
+
+        size_t allocationsBefore = allocationCount();
+        size_t bytesBefore = allocatedBytes();
+        auto start = std::chrono::steady_clock::now();
+        body();
+        seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        allocationTotal += allocationCount() - allocationsBefore;
+        byteTotal += allocatedBytes() - bytesBefore;
+        ++iterations;
+    }
+
+    double totalOps = static_cast<double>(iterations) * (ops ? ops : 1);
+    Result result;
+    result.name = name;
+    result.size = size;
+    result.nsPerOp = seconds * 1e9 / totalOps;
+    result.allocationsPerOp = allocationTotal / totalOps;
+    result.bytesPerOp = byteTotal / totalOps;
+    result.opsPerSecond = seconds > 0 ? totalOps / seconds : 0;
+    results.push_back(result);
+
+    std::cout << std::left << std::setw(36) << (name + "/" + std::to_string(size))
+        << std::right << std::fixed << std::setprecision(1)
+        << std::setw(14) << result.nsPerOp << " ns/op"
+        << std::setw(10) << result.allocationsPerOp << " allocs/op"
+        << std::setw(12) << result.bytesPerOp << " B/op"
+        << std::setw(16) << std::setprecision(0) << result.opsPerSecond << " ops/s" << std::endl;
+}
+
+int Runner::finish() {
+    if (jsonPath.empty()) {
+        return 0;
+    }
+
+    std::ofstream out(jsonPath);
+    if (!out) {
+        std::cerr << "Cannot write " << jsonPath << std::endl;
+        return 1;
+    }
+
+    out << "{\n  \"benchmarks\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result& r = results[i];
+        out << "    {\"name\": \"" << r.name << "\", \"size\": " << r.size
+            << std::setprecision(6)
+            << ", \"ns_per_op\": " << r.nsPerOp
+            << ", \"allocations_per_op\": " << r.allocationsPerOp
+            << ", \"bytes_per_op\": " << r.bytesPerOp
+            << ", \"ops_per_second\": " << r.opsPerSecond << "}"
+            << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+    out << "  ]\n}\n";
+    return out ? 0 : 1;
+}
+
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Небольшой набор инструментов для микробенчмарков лабораторных.
+// Каждая программа bench_* подключает файл лабораторной с LB_NO_MAIN и замеряет её операции
+namespace bench {
+
+// Результат одного замера
+struct Result {
+    std::string name;
+    size_t size;
+    double nsPerOp;
+    double allocationsPerOp;
+    double bytesPerOp;
+    double opsPerSecond;
+};
+
+// Число выделений памяти и выделенных байт с начала программы
+size_t allocationCount();
+size_t allocatedBytes();
+
+// Не даёт компилятору выбросить вычисление, результат которого не используется
+void doNotOptimize(const void* value);
+
+// Запускает замеры и собирает результаты.
+// Параметры командной строки: --json=<файл> (результаты в JSON), --filter=<подстрока>,
+// --min-time=<секунды> (минимальное суммарное время замера, по умолчанию 0.2)
+class Runner {
+public:
+    Runner(int argc, char** argv);
+
+    // setup() готовит данные и не замеряется, body() выполняет ops операций и замеряется.
+    // Пара повторяется, пока суммарное время body() не достигнет min-time,
+    // затем строка с результатом сразу печатается в std::cout
+    void run(const std::string& name, size_t size, size_t ops,
+        const std::function<void()>& setup, const std::function<void()>& body);
+
+    // То же без подготовки
+    void run(const std::string& name, size_t size, size_t ops, const std::function<void()>& body);
+
+    // Пишет результаты в JSON, если задан --json, и возвращает код завершения программы:
+    // 1, если файл записать не удалось. Таблица к этому моменту уже напечатана в run()
+    int finish();
+
+private:
+    std::vector<Result> results;
+    std::string jsonPath;
+    std::string filter;
+    double minSeconds = 0.2;
+};
+
+}
@@ -0,0 +1,159 @@
+#pragma once
+
+// Монотонная арена для временных объектов боя: память выделяется сдвигом указателя
+// внутри крупных блоков, освобождение отдельных объектов ничего не делает,
+// а reset() за O(1) возвращает арену в начало, сохраняя блоки для следующего боя.
+// Арена - это std::pmr::memory_resource, поэтому её принимают std::pmr::string,
+// std::pmr::vector и другие контейнеры std::pmr (C++17).
+// arena::Scope делает арену текущей для потока, arena::resource() возвращает
+// текущую арену или ресурс по умолчанию, если бой идёт без арены
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <new>
+
+namespace arena {
+
+class Arena : public std::pmr::memory_resource {
+public:
+    static constexpr size_t defaultChunkSize = 64 * 1024;
+    // Каждый следующий блок вдвое больше предыдущего, но не больше chunkSize * maxGrowth
+    static constexpr size_t maxGrowth = 64;
+
+    explicit Arena(size_t chunkSize = defaultChunkSize,
+        std::pmr::memory_resource* upstream = std::pmr::get_default_resource())
+        : chunkSize(chunkSize), nextChunkSize(chunkSize), upstream(upstream) {
+    }
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    ~Arena() override {
+        while (first) {
+            Chunk* next = first->next;
+            upstream->deallocate(first, first->size, alignof(Chunk));
+            first = next;
+        }
+    }
+
+    // Все выделенные ранее объекты становятся недействительными, блоки остаются у арены
+    void reset() noexcept {
+        current = first;
+        cursor = first ? first->data() : nullptr;
+        used = 0;
+    }
+
+    size_t bytesUsed() const { return used; }
+    size_t bytesReserved() const { return reserved; }
+
+private:
+    struct Chunk {
+        Chunk* next;
+        size_t size; // Вместе с заголовком
+
+        char* data() { return reinterpret_cast<char*>(this + 1); }
+        char* end() { return reinterpret_cast<char*>(this) + size; }
+    };
+
+    static char* alignUp(char* p, size_t alignment) {
+        uintptr_t value = reinterpret_cast<uintptr_t>(p);
+        return reinterpret_cast<char*>((value + alignment - 1) & ~(uintptr_t(alignment) - 1));
+    }
+
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        while (current) {
+            char* p = alignUp(cursor, alignment);
+            if (p <= current->end() && bytes <= static_cast<size_t>(current->end() - p)) {
+                cursor = p + bytes;
+                used += bytes;
+                return p;
+            }
+            // Следующий блок остался от прошлых боёв - продолжаем в нём
+            if (!current->next) {
+                break;
+            }
+            current = current->next;
+            cursor = current->data();
+        }
+
+        // Новый блок встаёт сразу за текущим, уже накопленные блоки не теряются
+        if (bytes > SIZE_MAX - sizeof(Chunk) - alignment) {
+            throw std::bad_alloc();
+        }
+        size_t size = sizeof(Chunk) + bytes + alignment;
+        if (size < nextChunkSize) {
+            size = nextChunkSize;
+        }
+        if (nextChunkSize < chunkSize * maxGrowth) {
+            nextChunkSize *= 2;
+        }
+        Chunk* chunk = static_cast<Chunk*>(upstream->allocate(size, alignof(Chunk)));
+        chunk->size = size;
+        if (current) {
+            chunk->next = current->next;
+            current->next = chunk;
+        }
+        else {
+            chunk->next = nullptr;
+            first = chunk;
+        }
+        current = chunk;
+        reserved += size;
+
+        char* p = alignUp(chunk->data(), alignment);
+        cursor = p + bytes;
+        used += bytes;
+        return p;
+    }
+
+    void do_deallocate(void*, size_t, size_t) override {
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+    size_t chunkSize;
+    size_t nextChunkSize;
+    std::pmr::memory_resource* upstream;
+    Chunk* first = nullptr;
+    Chunk* current = nullptr;
+    char* cursor = nullptr;
+    size_t used = 0;
+    size_t reserved = 0;
+};
+
+inline Arena*& activeArena() {
+    thread_local Arena* active = nullptr;
+    return active;
+}
+
+// Ресурс для временных объектов в текущем потоке
+inline std::pmr::memory_resource* resource() {
+    Arena* active = activeArena();
+    return active ? static_cast<std::pmr::memory_resource*>(active) : std::pmr::get_default_resource();
+}
+
+// Бой или тик: пока объект жив, арена текущая для потока, при выходе она сбрасывается.
+// Объекты из арены не должны переживать Scope
+class Scope {
+public:
+    explicit Scope(Arena& arena) : arena(arena), previous(activeArena()) {
+        activeArena() = &arena;
+    }
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+    ~Scope() {
+        activeArena() = previous;
+        arena.reset();
+    }
+
+private:
+    Arena& arena;
+    Arena* previous;
+};
+
+}
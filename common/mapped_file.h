@@ -0,0 +1,149 @@
+#pragma once
+
+// Чтение больших текстовых файлов без копирования: mapped::File отображает файл в память
+// только для чтения, splitByLines делит текст на части по границам строк для параллельного разбора,
+// skipSpaces и skipToken двигаются по строке между полями.
+// File::open возвращает false при ошибке, исключение выбирает сама лабораторная
+
+#include <algorithm>
+#include <cstddef>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace mapped {
+
+class File {
+    const char* bytes = nullptr;
+    size_t length = 0;
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+#else
+    int fd = -1;
+#endif
+
+public:
+    File() = default;
+
+    File(const File&) = delete;
+    File& operator=(const File&) = delete;
+
+    ~File() {
+        close();
+    }
+
+    bool open(const std::string& filename) {
+        close();
+#ifdef _WIN32
+        file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        LARGE_INTEGER fileSize;
+        if (file == INVALID_HANDLE_VALUE || !GetFileSizeEx(file, &fileSize)) {
+            close();
+            return false;
+        }
+        length = static_cast<size_t>(fileSize.QuadPart);
+        if (length > 0) {
+            mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            void* view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+            if (!view) {
+                close();
+                return false;
+            }
+            bytes = static_cast<const char*>(view);
+        }
+#else
+        fd = ::open(filename.c_str(), O_RDONLY);
+        struct stat info;
+        if (fd < 0 || ::fstat(fd, &info) != 0) {
+            close();
+            return false;
+        }
+        length = static_cast<size_t>(info.st_size);
+        if (length > 0) {
+            void* view = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (view == MAP_FAILED) {
+                close();
+                return false;
+            }
+            ::madvise(view, length, MADV_SEQUENTIAL);
+            bytes = static_cast<const char*>(view);
+        }
+#endif
+        return true;
+    }
+
+    const char* data() const { return bytes; }
+    size_t size() const { return length; }
+
+private:
+    void close() {
+#ifdef _WIN32
+        if (bytes) UnmapViewOfFile(bytes);
+        if (mapping) CloseHandle(mapping);
+        if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+        mapping = nullptr;
+        file = INVALID_HANDLE_VALUE;
+#else
+        if (bytes) ::munmap(const_cast<char*>(bytes), length);
+        if (fd >= 0) ::close(fd);
+        fd = -1;
+#endif
+        bytes = nullptr;
+        length = 0;
+    }
+};
+
+// Делит текст на части примерно равного размера по границам строк,
+// не больше одной части на ядро и не меньше minChunkSize байт в части
+inline std::vector<std::pair<const char*, const char*>> splitByLines(const char* data, size_t size) {
+    const size_t minChunkSize = 1 << 20;
+    size_t parts = std::max<size_t>(1, std::min<size_t>(std::thread::hardware_concurrency(), size / minChunkSize));
+
+    std::vector<std::pair<const char*, const char*>> chunks;
+    const char* end = data + size;
+    const char* begin = data;
+    for (size_t i = 1; i <= parts && begin != end; ++i) {
+        const char* cut = (i == parts) ? end : data + size / parts * i;
+        if (cut < begin) {
+            cut = begin;
+        }
+        cut = std::find(cut, end, '\n');
+        if (cut != end) {
+            ++cut;
+        }
+        chunks.emplace_back(begin, cut);
+        begin = cut;
+    }
+    return chunks;
+}
+
+inline const char* skipSpaces(const char* p, const char* end) {
+    while (p != end && (*p == ' ' || *p == '\t' || *p == '\r')) {
+        ++p;
+    }
+    return p;
+}
+
+inline const char* skipToken(const char* p, const char* end) {
+    while (p != end && *p != ' ' && *p != '\t' && *p != '\r') {
+        ++p;
+    }
+    return p;
+}
+
+}
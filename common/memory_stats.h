@@ -0,0 +1,167 @@
+#pragma once
+
+// Учёт выделений памяти по подсистемам: сколько байт занято сейчас, пиковое значение,
+// число выделений и освобождений. Подсистема заводится по имени через memstats::subsystem(),
+// память считается либо аллокатором CountingAllocator<T> (для обычных контейнеров),
+// либо ресурсом CountingResource (для контейнеров std::pmr, C++17).
+// memstats::report() печатает таблицу по всем подсистемам
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <ostream>
+#include <string>
+
+#if __cplusplus >= 201703L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201703L)
+#include <memory_resource>
+#define LB_HAS_PMR 1
+#endif
+
+namespace memstats {
+
+class AllocationStats {
+    std::atomic<size_t> liveBytes{ 0 };
+    std::atomic<size_t> peakBytes{ 0 };
+    std::atomic<size_t> totalBytes{ 0 };
+    std::atomic<size_t> allocationCount{ 0 };
+    std::atomic<size_t> deallocationCount{ 0 };
+
+public:
+    void onAllocate(size_t bytes) {
+        size_t live = liveBytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+        totalBytes.fetch_add(bytes, std::memory_order_relaxed);
+        allocationCount.fetch_add(1, std::memory_order_relaxed);
+
+        size_t peak = peakBytes.load(std::memory_order_relaxed);
+        while (live > peak && !peakBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+        }
+    }
+
+    void onDeallocate(size_t bytes) {
+        liveBytes.fetch_sub(bytes, std::memory_order_relaxed);
+        deallocationCount.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    size_t live() const { return liveBytes.load(std::memory_order_relaxed); }
+    size_t peak() const { return peakBytes.load(std::memory_order_relaxed); }
+    size_t total() const { return totalBytes.load(std::memory_order_relaxed); }
+    size_t allocations() const { return allocationCount.load(std::memory_order_relaxed); }
+    size_t deallocations() const { return deallocationCount.load(std::memory_order_relaxed); }
+};
+
+struct Registry {
+    std::mutex mutex;
+    std::map<std::string, std::unique_ptr<AllocationStats>> subsystems;
+};
+
+inline Registry& registry() {
+    static Registry instance;
+    return instance;
+}
+
+// Ссылка остаётся действительной до конца программы, её стоит сохранить, а не искать каждый раз
+inline AllocationStats& subsystem(const std::string& name) {
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    auto& stats = r.subsystems[name];
+    if (!stats) {
+        stats = std::make_unique<AllocationStats>();
+    }
+    return *stats;
+}
+
+inline void report(std::ostream& out) {
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    out << std::left << std::setw(20) << "subsystem" << std::right
+        << std::setw(10) << "allocs" << std::setw(10) << "frees"
+        << std::setw(12) << "live B" << std::setw(12) << "peak B" << std::setw(14) << "total B" << "\n";
+    for (const auto& entry : r.subsystems) {
+        const AllocationStats& s = *entry.second;
+        out << std::left << std::setw(20) << entry.first << std::right
+            << std::setw(10) << s.allocations() << std::setw(10) << s.deallocations()
+            << std::setw(12) << s.live() << std::setw(12) << s.peak() << std::setw(14) << s.total() << "\n";
+    }
+}
+
+// Аллокатор для стандартных контейнеров: память берётся из operator new,
+// каждое выделение записывается в статистику своей подсистемы
+template<typename T>
+class CountingAllocator {
+    template<typename U> friend class CountingAllocator;
+
+    AllocationStats* stats;
+
+public:
+    using value_type = T;
+
+    explicit CountingAllocator(AllocationStats& stats) noexcept : stats(&stats) {}
+
+    template<typename U>
+    CountingAllocator(const CountingAllocator<U>& other) noexcept : stats(other.stats) {}
+
+    T* allocate(size_t n) {
+        if (n > static_cast<size_t>(-1) / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        T* p = static_cast<T*>(::operator new(n * sizeof(T)));
+        stats->onAllocate(n * sizeof(T));
+        return p;
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        stats->onDeallocate(n * sizeof(T));
+        ::operator delete(p);
+    }
+
+    AllocationStats& getStats() const noexcept { return *stats; }
+
+    template<typename U>
+    bool operator==(const CountingAllocator<U>& other) const noexcept { return stats == other.stats; }
+
+    template<typename U>
+    bool operator!=(const CountingAllocator<U>& other) const noexcept { return stats != other.stats; }
+};
+
+#ifdef LB_HAS_PMR
+// Ресурс памяти, который передаёт выделения вышестоящему ресурсу и ведёт статистику.
+// Вышестоящим может быть, например, std::pmr::monotonic_buffer_resource или пул
+class CountingResource : public std::pmr::memory_resource {
+    AllocationStats& stats;
+    std::pmr::memory_resource* upstream;
+
+public:
+    explicit CountingResource(AllocationStats& stats,
+        std::pmr::memory_resource* upstream = std::pmr::get_default_resource())
+        : stats(stats), upstream(upstream) {
+    }
+
+    CountingResource(const CountingResource&) = delete;
+    CountingResource& operator=(const CountingResource&) = delete;
+
+    AllocationStats& getStats() const { return stats; }
+
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        void* p = upstream->allocate(bytes, alignment);
+        stats.onAllocate(bytes);
+        return p;
+    }
+
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+        stats.onDeallocate(bytes);
+        upstream->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+#endif
+
+}
@@ -0,0 +1,253 @@
+#pragma once
+
+// Глобальная таблица интернированных строк: каждое имя хранится один раз,
+// а объекты держат 32-битный symbols::Symbol. Сравнение символов - сравнение чисел,
+// view() возвращает std::string_view на хранимую строку без блокировок.
+// Таблица разбита на сегменты по хешу строки, у каждого свой std::shared_mutex,
+// поэтому потоки, добавляющие разные имена, почти не мешают друг другу.
+// Строки не удаляются до конца программы
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <shared_mutex>
+#include <stdexcept>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace symbols {
+
+class Table {
+public:
+    // Номер символа: младшие shardBits бит - сегмент таблицы, остальные - позиция в сегменте.
+    // Номер 0 - пустая строка
+    static constexpr unsigned shardBits = 4;
+    static constexpr uint32_t shardCount = 1u << shardBits;
+
+    Table() {
+        shards[0].add(std::string_view(), 0);
+    }
+
+    Table(const Table&) = delete;
+    Table& operator=(const Table&) = delete;
+
+    uint32_t intern(std::string_view text) {
+        if (text.empty()) {
+            return 0;
+        }
+        size_t hash = std::hash<std::string_view>()(text);
+        uint32_t shard = static_cast<uint32_t>(hash % shardCount);
+        return (shards[shard].intern(text) << shardBits) | shard;
+    }
+
+    // Поиск без добавления: запросы по именам, которых нет в таблице, её не засоряют
+    bool find(std::string_view text, uint32_t& id) const {
+        if (text.empty()) {
+            id = 0;
+            return true;
+        }
+        size_t hash = std::hash<std::string_view>()(text);
+        uint32_t shard = static_cast<uint32_t>(hash % shardCount);
+        uint32_t index;
+        if (!shards[shard].find(text, index)) {
+            return false;
+        }
+        id = (index << shardBits) | shard;
+        return true;
+    }
+
+    std::string_view view(uint32_t id) const {
+        return shards[id & (shardCount - 1)].view(id >> shardBits);
+    }
+
+    // Число разных строк в таблице
+    size_t size() const {
+        size_t total = 0;
+        for (const Shard& shard : shards) {
+            total += shard.size();
+        }
+        return total;
+    }
+
+private:
+    class Shard {
+    public:
+        uint32_t intern(std::string_view text) {
+            {
+                std::shared_lock<std::shared_mutex> lock(mutex);
+                auto it = ids.find(text);
+                if (it != ids.end()) {
+                    return it->second;
+                }
+            }
+
+            std::unique_lock<std::shared_mutex> lock(mutex);
+            auto it = ids.find(text);
+            if (it != ids.end()) {
+                return it->second;
+            }
+            uint32_t index = count.load(std::memory_order_relaxed);
+            add(text, index);
+            return index;
+        }
+
+        bool find(std::string_view text, uint32_t& index) const {
+            std::shared_lock<std::shared_mutex> lock(mutex);
+            auto it = ids.find(text);
+            if (it == ids.end()) {
+                return false;
+            }
+            index = it->second;
+            return true;
+        }
+
+        // Без блокировки: записи не перемещаются, а символ попадает к читателю
+        // только после того, как его запись заполнена
+        std::string_view view(uint32_t index) const {
+            uint32_t segment = segmentOf(index);
+            const std::string_view* entries = segments[segment].load(std::memory_order_acquire);
+            return entries[index - segmentStart(segment)];
+        }
+
+        size_t size() const { return count.load(std::memory_order_relaxed); }
+
+        // Вызывается под исключительной блокировкой (или в конструкторе таблицы)
+        void add(std::string_view text, uint32_t index) {
+            if (index >> (32 - shardBits) != 0) {
+                throw std::length_error("Symbol table is full");
+            }
+
+            uint32_t segment = segmentOf(index);
+            std::string_view* entries = segments[segment].load(std::memory_order_relaxed);
+            if (!entries) {
+                entries = new std::string_view[segmentSize(segment)];
+                segments[segment].store(entries, std::memory_order_release);
+            }
+
+            std::string_view stored = store(text);
+            ids.emplace(stored, index);
+            entries[index - segmentStart(segment)] = stored;
+            count.store(index + 1, std::memory_order_release);
+        }
+
+        ~Shard() {
+            for (auto& segment : segments) {
+                delete[] segment.load(std::memory_order_relaxed);
+            }
+        }
+
+    private:
+        // Сегмент s вмещает firstSegment << s записей, поэтому массивы записей
+        // растут без перемещения, а их число ограничено
+        static constexpr uint32_t firstSegment = 256;
+        static constexpr int maxSegments = 32;
+        static constexpr size_t blockSize = 16 * 1024;
+
+        static uint32_t segmentOf(uint32_t index) {
+            uint64_t block = uint64_t(index) / firstSegment + 1;
+            uint32_t segment = 0;
+            while (block >>= 1) {
+                ++segment;
+            }
+            return segment;
+        }
+
+        static uint64_t segmentStart(uint32_t segment) {
+            return uint64_t(firstSegment) * ((uint64_t(1) << segment) - 1);
+        }
+
+        static size_t segmentSize(uint32_t segment) {
+            return size_t(firstSegment) << segment;
+        }
+
+        // Символы строк лежат подряд в крупных блоках, длинная строка получает свой блок
+        std::string_view store(std::string_view text) {
+            if (text.empty()) {
+                return std::string_view();
+            }
+
+            char* p;
+            if (text.size() > blockSize / 4) {
+                blocks.push_back(std::make_unique<char[]>(text.size()));
+                p = blocks.back().get();
+            }
+            else {
+                if (text.size() > blockLeft) {
+                    blocks.push_back(std::make_unique<char[]>(blockSize));
+                    cursor = blocks.back().get();
+                    blockLeft = blockSize;
+                }
+                p = cursor;
+                cursor += text.size();
+                blockLeft -= text.size();
+            }
+            std::copy(text.begin(), text.end(), p);
+            return std::string_view(p, text.size());
+        }
+
+        mutable std::shared_mutex mutex;
+        std::unordered_map<std::string_view, uint32_t> ids;
+        std::atomic<std::string_view*> segments[maxSegments] = {};
+        std::atomic<uint32_t> count{ 0 };
+        std::vector<std::unique_ptr<char[]>> blocks;
+        char* cursor = nullptr;
+        size_t blockLeft = 0;
+    };
+
+    Shard shards[shardCount];
+};
+
+inline Table& table() {
+    static Table instance;
+    return instance;
+}
+
+class Symbol {
+public:
+    Symbol() = default;
+
+    explicit Symbol(std::string_view text) : id(table().intern(text)) {}
+
+    std::string_view view() const { return table().view(id); }
+    uint32_t getId() const { return id; }
+    bool empty() const { return id == 0; }
+
+    friend bool operator==(Symbol a, Symbol b) { return a.id == b.id; }
+    friend bool operator!=(Symbol a, Symbol b) { return a.id != b.id; }
+
+    // Порядок номеров, а не строк: годится для сортировки и std::map, но не для вывода по алфавиту
+    friend bool operator<(Symbol a, Symbol b) { return a.id < b.id; }
+
+private:
+    friend bool find(std::string_view text, Symbol& symbol);
+
+    uint32_t id = 0;
+};
+
+// Символ уже известной строки; false, если такой строки ещё не было
+inline bool find(std::string_view text, Symbol& symbol) {
+    return table().find(text, symbol.id);
+}
+
+inline std::ostream& operator<<(std::ostream& out, Symbol symbol) {
+    return out << symbol.view();
+}
+
+}
+
+namespace std {
+
+template<>
+struct hash<symbols::Symbol> {
+    size_t operator()(symbols::Symbol symbol) const {
+        return std::hash<uint32_t>()(symbol.getId());
+    }
+};
+
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+// Растущий текстовый буфер для вывода: строки дописываются в конец, целые числа
+// форматируются через std::to_chars без локалей и потоков ввода-вывода.
+// Готовый текст отправляется одним вызовом write в консоль, файл или любой другой std::ostream,
+// а view() позволяет передать его дальше без копирования
+
+#include <charconv>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace text {
+
+class Buffer {
+    std::string data;
+
+public:
+    // Размер, после которого flushIfFull отдаёт накопленный текст
+    static constexpr size_t blockSize = 64 * 1024;
+
+    Buffer& operator<<(std::string_view s) {
+        data.append(s.data(), s.size());
+        return *this;
+    }
+
+    Buffer& operator<<(char c) {
+        data.push_back(c);
+        return *this;
+    }
+
+    template<typename T, std::enable_if_t<std::is_integral<T>::value
+        && !std::is_same<T, char>::value && !std::is_same<T, bool>::value, int> = 0>
+    Buffer& operator<<(T value) {
+        char digits[24];
+        auto result = std::to_chars(digits, digits + sizeof(digits), value);
+        data.append(digits, result.ptr);
+        return *this;
+    }
+
+    void reserve(size_t bytes) { data.reserve(bytes); }
+    void clear() { data.clear(); }
+    size_t size() const { return data.size(); }
+    bool empty() const { return data.empty(); }
+    std::string_view view() const { return data; }
+
+    // Записывает весь текст одним вызовом и очищает буфер (память остаётся для следующего вывода)
+    void flushTo(std::ostream& out) {
+        out.write(data.data(), static_cast<std::streamsize>(data.size()));
+        data.clear();
+    }
+
+    // Для длинных списков: отдаёт текст крупными блоками, чтобы буфер не рос без ограничений
+    void flushIfFull(std::ostream& out) {
+        if (data.size() >= blockSize) {
+            flushTo(out);
+        }
+    }
+};
+
+}
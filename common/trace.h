@@ -0,0 +1,182 @@
+#pragma once
+
+// Замер горячих участков кода: TRACE_SCOPE("имя") засекает время до конца области видимости,
+// TRACE_COUNTER("имя", значение) записывает значение счётчика.
+// Включается сборкой с LB_TRACE=1, иначе макросы ничего не делают и не попадают в код.
+// События пишутся в буфер своего потока без блокировок; после завершения рабочих потоков
+// TRACE_DUMP("префикс") сохраняет префикс.json (chrome://tracing, Perfetto)
+// и префикс.folded (flamegraph.pl, speedscope)
+
+#ifndef LB_TRACE
+#define LB_TRACE 0
+#endif
+
+#if LB_TRACE
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace trace {
+
+struct Event {
+    const char* name;
+    uint64_t start;    // нс от запуска программы
+    uint64_t duration; // нс; для счётчиков не используется
+    int64_t value;     // значение счётчика
+    bool counter;
+};
+
+struct ThreadBuffer {
+    unsigned id;
+    std::vector<Event> events;
+};
+
+// Буферы всех потоков; мьютекс нужен только при первом событии потока и при выгрузке
+struct Registry {
+    std::mutex mutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+    std::chrono::steady_clock::time_point origin = std::chrono::steady_clock::now();
+};
+
+inline Registry& registry() {
+    static Registry instance;
+    return instance;
+}
+
+inline uint64_t now() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - registry().origin).count());
+}
+
+inline ThreadBuffer& threadBuffer() {
+    thread_local ThreadBuffer* buffer = nullptr;
+    if (!buffer) {
+        Registry& r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        r.buffers.push_back(std::make_unique<ThreadBuffer>());
+        buffer = r.buffers.back().get();
+        buffer->id = static_cast<unsigned>(r.buffers.size());
+        buffer->events.reserve(1 << 16);
+    }
+    return *buffer;
+}
+
+class Scope {
+public:
+    explicit Scope(const char* name) : name(name), start(now()) {}
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+    ~Scope() {
+        uint64_t end = now();
+        threadBuffer().events.push_back({ name, start, end - start, 0, false });
+    }
+
+private:
+    const char* name;
+    uint64_t start;
+};
+
+inline void counter(const char* name, int64_t value) {
+    threadBuffer().events.push_back({ name, now(), 0, value, true });
+}
+
+inline void writeChromeTrace(const std::string& filename) {
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    std::ofstream out(filename);
+    out << std::fixed << std::setprecision(3) << "{\"traceEvents\":[\n";
+    bool first = true;
+    for (const auto& buffer : r.buffers) {
+        for (const Event& e : buffer->events) {
+            out << (first ? "" : ",\n");
+            first = false;
+            if (e.counter) {
+                out << "{\"name\":\"" << e.name << "\",\"ph\":\"C\",\"ts\":" << e.start / 1000.0
+                    << ",\"pid\":1,\"tid\":" << buffer->id << ",\"args\":{\"value\":" << e.value << "}}";
+            }
+            else {
+                out << "{\"name\":\"" << e.name << "\",\"ph\":\"X\",\"ts\":" << e.start / 1000.0
+                    << ",\"dur\":" << e.duration / 1000.0 << ",\"pid\":1,\"tid\":" << buffer->id << "}";
+            }
+        }
+    }
+    out << "\n]}\n";
+}
+
+// Свёрнутые стеки: "внешний;вложенный;... собственное_время_в_мкс".
+// Вложенность восстанавливается по времени начала и длительности событий потока
+inline void writeFoldedStacks(const std::string& filename) {
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    std::map<std::string, uint64_t> selfTime;
+
+    for (const auto& buffer : r.buffers) {
+        std::vector<const Event*> scopes;
+        for (const Event& e : buffer->events) {
+            if (!e.counter) {
+                scopes.push_back(&e);
+            }
+        }
+        std::sort(scopes.begin(), scopes.end(), [](const Event* a, const Event* b) {
+            return a->start != b->start ? a->start < b->start : a->duration > b->duration;
+        });
+
+        struct Open {
+            const Event* event;
+            std::string path;
+            uint64_t children;
+        };
+        std::vector<Open> stack;
+        auto close = [&selfTime, &stack] {
+            Open& top = stack.back();
+            selfTime[top.path] += top.event->duration - std::min(top.children, top.event->duration);
+            stack.pop_back();
+        };
+
+        for (const Event* e : scopes) {
+            while (!stack.empty() && stack.back().event->start + stack.back().event->duration <= e->start) {
+                close();
+            }
+            std::string path = stack.empty() ? e->name : stack.back().path + ";" + e->name;
+            if (!stack.empty()) {
+                stack.back().children += e->duration;
+            }
+            stack.push_back({ e, path, 0 });
+        }
+        while (!stack.empty()) {
+            close();
+        }
+    }
+
+    std::ofstream out(filename);
+    for (const auto& entry : selfTime) {
+        out << entry.first << " " << entry.second / 1000 << "\n";
+    }
+}
+
+}
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+#define TRACE_SCOPE(name) ::trace::Scope TRACE_CONCAT(traceScope, __LINE__)(name)
+#define TRACE_COUNTER(name, value) ::trace::counter(name, static_cast<int64_t>(value))
+#define TRACE_DUMP(prefix) \
+    (::trace::writeChromeTrace(std::string(prefix) + ".json"), ::trace::writeFoldedStacks(std::string(prefix) + ".folded"))
+
+#else
+
+#define TRACE_SCOPE(name) ((void)0)
+#define TRACE_COUNTER(name, value) ((void)0)
+#define TRACE_DUMP(prefix) ((void)0)
+
+#endif
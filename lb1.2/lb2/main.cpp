@@ -1,74 +1,83 @@
-#include <iostream>
-#include <string>
-
-class Entity {
-protected:
-    std::string name;
-    int health;
-
-public:
-    Entity(const std::string& n, int h) : name(n), health(h) {}
-
-    virtual void displayInfo() const {
-        std::cout << "Name: " << name << ", HP: " << health << std::endl;
-    }
-
-    virtual ~Entity() {}
-};
-
-class Player : public Entity {
-private:
-    int experience;
-
-public:
-    Player(const std::string& n, int h, int exp)
-        : Entity(n, h), experience(exp) {
-    }
-
-    void displayInfo() const override {
-        Entity::displayInfo();
-        std::cout << "Experience: " << experience << std::endl;
-    }
-};
-
-class Enemy : public Entity {
-private:
-    std::string type;
-
-public:
-    Enemy(const std::string& n, int h, const std::string& t)
-        : Entity(n, h), type(t) {
-    }
-
-    void displayInfo() const override {
-        Entity::displayInfo();
-        std::cout << "Type: " << type << std::endl;
-    }
-};
-
-class Boss : public Enemy {
-private:
-    std::string specialAbility = "Mega puper special ability";
-
-public:
-    Boss(const std::string& n, int h, const std::string& t)
-        : Enemy(n, h, t) {
-    }
-
-    void displayInfo() const override {
-        Enemy::displayInfo();
-        std::cout << "Description of boss's special ability: " << specialAbility << std::endl;
-    }
-};
-
-int main() {
-    Player hero("Hero", 100, 0);
-    Enemy monster("Goblin", 50, "Goblin");
-    Boss boss("Fisk", 200, "Golem");
-
-    hero.displayInfo();
-    monster.displayInfo();
-    boss.displayInfo();
-
-    return 0;
-}
+#include <iostream>
+#include <string>
+
+#include "../../common/text_buffer.h"
+
+class Entity {
+protected:
+    std::string name;
+    int health;
+
+public:
+    Entity(const std::string& n, int h) : name(n), health(h) {}
+
+    //        
+    void displayInfo() const {
+        text::Buffer out;
+        writeInfo(out);
+        out.flushTo(std::cout);
+    }
+
+    virtual void writeInfo(text::Buffer& out) const {
+        out << "Name: " << name << ", HP: " << health << '\n';
+    }
+
+    virtual ~Entity() {}
+};
+
+class Player : public Entity {
+private:
+    int experience;
+
+public:
+    Player(const std::string& n, int h, int exp)
+        : Entity(n, h), experience(exp) {
+    }
+
+    void writeInfo(text::Buffer& out) const override {
+        Entity::writeInfo(out);
+        out << "Experience: " << experience << '\n';
+    }
+};
+
+class Enemy : public Entity {
+private:
+    std::string type;
+
+public:
+    Enemy(const std::string& n, int h, const std::string& t)
+        : Entity(n, h), type(t) {
+    }
+
+    void writeInfo(text::Buffer& out) const override {
+        Entity::writeInfo(out);
+        out << "Type: " << type << '\n';
+    }
+};
+
+class Boss : public Enemy {
+private:
+    std::string specialAbility = "Mega puper special ability";
+
+public:
+    Boss(const std::string& n, int h, const std::string& t)
+        : Enemy(n, h, t) {
+    }
+
+    void writeInfo(text::Buffer& out) const override {
+        Enemy::writeInfo(out);
+        out << "Description of boss's special ability: " << specialAbility << '\n';
+    }
+};
+
+int main() {
+    Player hero("Hero", 100, 0);
+    Enemy monster("Goblin", 50, "Goblin");
+    Boss boss("Fisk", 200, "Golem");
+
+    hero.displayInfo();
+    monster.displayInfo();
+    boss.displayInfo();
+
+    return 0;
+}
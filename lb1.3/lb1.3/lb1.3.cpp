@@ -1,168 +1,866 @@
-﻿#include <iostream>
-#include <string>
-#include <cstdlib> // для rand() и srand()
-#include <ctime>   // для time()
-
-class Entity {
-protected:
-    std::string name;
-    int health;
-    int attack;
-    int defense;
-
-public:
-    Entity(const std::string& n, int h, int a, int d)
-        : name(n), health(h), attack(a), defense(d) {
-    }
-
-    // Виртуальный метод для атаки
-    virtual void attackEnemy(Entity& target) {
-        int damage = attack - target.defense;
-        if (damage > 0) {
-            target.health -= damage;
-            std::cout << name << " attacks " << target.name << " for " << damage << " damage!\n";
-        }
-        else {
-            std::cout << name << " attacks " << target.name << ", but it has no effect!\n";
-        }
-    }
-
-    // Виртуальный метод для вывода информации
-    virtual void displayInfo() const {
-        std::cout << "Name: " << name << ", HP: " << health
-            << ", Attack: " << attack << ", Defense: " << defense << std::endl;
-    }
-
-    // Геттеры
-    int getDefence() const { return defense; }
-    std::string getName() const { return name; }
-
-    // Сеттер для получения урона
-    void takeDamage(int damage) { health -= damage; }
-
-    // Виртуальный метод для лечения
-    virtual void heal(int amount) {
-        health += amount;
-        std::cout << name << " heals for " << amount << " HP. Current HP: " << health << std::endl;
-    }
-
-    // Виртуальный деструктор
-    virtual ~Entity() {}
-};
-
-class Character : public Entity {
-public:
-    Character(const std::string& n, int h, int a, int d)
-        : Entity(n, h, a, d) {
-    }
-
-    // Переопределение метода attack
-    void attackEnemy(Entity& target) override {
-        int damage = attack - target.getDefence();
-        if (damage > 0) {
-            // Шанс на критический удар (20%)
-            if (rand() % 100 < 20) {
-                damage *= 2;
-                std::cout << "Critical hit! ";
-            }
-            target.takeDamage(damage);
-            std::cout << name << " attacks " << target.getName() << " for " << damage << " damage!\n";
-        }
-        else {
-            std::cout << name << " attacks " << target.getName() << ", but it has no effect!\n";
-        }
-    }
-
-    // Переопределение метода displayInfo
-    void displayInfo() const override {
-        std::cout << "Character: " << name << ", HP: " << health
-            << ", Attack: " << attack << ", Defense: " << defense << std::endl;
-    }
-
-    // Переопределение метода heal
-    void heal(int amount) override {
-        health += amount;
-        std::cout << name << " uses healing spell and restores " << amount << " HP. Current HP: " << health << std::endl;
-    }
-};
-
-class Monster : public Entity {
-public:
-    Monster(const std::string& n, int h, int a, int d)
-        : Entity(n, h, a, d) {
-    }
-
-    // Переопределение метода attack
-    void attackEnemy(Entity& target) override {
-        int damage = attack - target.getDefence();
-        if (damage > 0) {
-            // Шанс на ядовитую атаку (30%)
-            if (rand() % 100 < 30) {
-                damage += 5; // Дополнительный урон от яда
-                std::cout << "Poisonous attack! ";
-            }
-            target.takeDamage(damage);
-            std::cout << name << " attacks " << target.getName() << " for " << damage << " damage!\n";
-        }
-        else {
-            std::cout << name << " attacks " << target.getName() << ", but it has no effect!\n";
-        }
-    }
-
-    // Переопределение метода displayInfo
-    void displayInfo() const override {
-        std::cout << "Monster: " << name << ", HP: " << health
-            << ", Attack: " << attack << ", Defense: " << defense << std::endl;
-    }
-};
-
-class Boss : public Monster {
-public:
-    Boss(const std::string& n, int h, int a, int d) : Monster(n, h, a, d) {}
-
-    void FireStrike(Entity& target) {
-        int damage = attack - target.getDefence();
-        if (damage > 0) {
-            // Шанс на ядовитую атаку (30%)
-            if (rand() % 100 < 30) {
-                damage += 5; // Дополнительный урон от яда
-                std::cout << "Poisonous attack! ";
-            }
-            target.takeDamage(damage);
-            std::cout << name << " attacks by Fire Strike " << target.getName() << " for " << damage << " damage!\n";
-        }
-        else {
-            std::cout << name << " attacks " << target.getName() << ", but enemy is Dodged!\n";
-        }
-    }
-};
-
-int main() {
-    srand(static_cast<unsigned>(time(0))); // Инициализация генератора случайных чисел
-
-    // Создание объектов
-    Character hero("Hero", 100, 20, 10);
-    Monster goblin("Goblin", 50, 15, 5);
-    Monster dragon("Dragon", 150, 25, 20);
-    Boss boss("Bob", 200, 50, 40);
-
-    // Массив указателей на базовый класс
-    Entity* entities[] = { &hero, &goblin, &dragon, &boss };
-
-    // Полиморфное поведение
-    for (auto& entity : entities) {
-        entity->displayInfo(); // Вывод информации о сущности
-    }
-
-    // Бой между персонажем и монстрами
-    hero.attackEnemy(goblin);
-    goblin.attackEnemy(hero);
-    dragon.attackEnemy(hero);
-    boss.attackEnemy(hero);
-    boss.FireStrike(hero);
-
-    // Персонаж лечится
-    hero.heal(30);
-
-    return 0;
-}
\ No newline at end of file
+﻿#include <iostream>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdint>
+#include <utility>
+#include <ctime>   // для time()
+
+#include "../../common/symbols.h"
+#include "../../common/text_buffer.h"
+
+// Генератор случайных чисел боя (splitmix64). При одинаковом seed последовательность одинакова
+// на любой платформе, а состояние - одно число, которое легко сохранить в контрольной точке
+class BattleRng {
+public:
+    explicit BattleRng(uint64_t seed = 0) : state(seed) {}
+
+    uint64_t next() {
+        uint64_t z = (state += 0x9e3779b97f4a7c15ULL);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+
+    // true с вероятностью percent процентов
+    bool chance(int percent) {
+        return static_cast<int>(next() % 100) < percent;
+    }
+
+    uint64_t getState() const { return state; }
+    void setState(uint64_t value) { state = value; }
+
+private:
+    uint64_t state;
+};
+
+class StatusEffects;
+
+// Всё, от чего зависит исход действий в бою: генератор случайных чисел, периодические эффекты
+// и вывод сообщений
+struct BattleContext {
+    BattleRng rng;
+    StatusEffects* effects = nullptr; // nullptr - бой без периодических эффектов
+    std::ostream* out = &std::cout;   // nullptr - бой без вывода (например, при повторе записи)
+};
+
+enum class EntityKind : uint8_t { Entity, Character, Monster, Boss };
+
+class Entity {
+protected:
+    symbols::Symbol name; // Одинаковые имена хранятся один раз в таблице символов
+    int health;
+    int attack;
+    int defense;
+
+public:
+    Entity(const std::string& n, int h, int a, int d)
+        : name(n), health(h), attack(a), defense(d) {
+    }
+
+    // Виртуальный метод для атаки
+    virtual void attackEnemy(Entity& target, BattleContext& battle) {
+        int damage = attack - target.defense;
+        if (damage > 0) {
+            target.health -= damage;
+            if (battle.out) {
+                *battle.out << name << " attacks " << target.name << " for " << damage << " damage!\n";
+            }
+        }
+        else if (battle.out) {
+            *battle.out << name << " attacks " << target.name << ", but it has no effect!\n";
+        }
+    }
+
+    // Вывод информации одной записью в std::cout
+    void displayInfo() const {
+        text::Buffer out;
+        writeInfo(out);
+        out.flushTo(std::cout);
+    }
+
+    // Виртуальный метод для записи информации в буфер
+    virtual void writeInfo(text::Buffer& out) const {
+        out << "Name: " << name.view() << ", HP: " << health
+            << ", Attack: " << attack << ", Defense: " << defense << '\n';
+    }
+
+    // Тип существа для записи боя
+    virtual EntityKind getKind() const { return EntityKind::Entity; }
+
+    // Геттеры
+    int getDefence() const { return defense; }
+    int getAttack() const { return attack; }
+    int getHealth() const { return health; }
+    std::string_view getName() const { return name.view(); }
+    symbols::Symbol getNameSymbol() const { return name; }
+
+    // Сеттер для получения урона
+    void takeDamage(int damage) { health -= damage; }
+
+    // Восстановление из контрольной точки повтора боя
+    void restoreHealth(int value) { health = value; }
+    void restoreDefense(int value) { defense = value; }
+
+    // Временное изменение защиты (эффекты усиления)
+    void changeDefense(int delta) { defense += delta; }
+
+    // Виртуальный метод для лечения
+    virtual void heal(int amount, BattleContext& battle) {
+        health += amount;
+        if (battle.out) {
+            *battle.out << name << " heals for " << amount << " HP. Current HP: " << health << '\n';
+        }
+    }
+
+    // Виртуальный деструктор
+    virtual ~Entity() {}
+};
+
+class Character : public Entity {
+public:
+    Character(const std::string& n, int h, int a, int d)
+        : Entity(n, h, a, d) {
+    }
+
+    // Переопределение метода attack
+    void attackEnemy(Entity& target, BattleContext& battle) override {
+        int damage = attack - target.getDefence();
+        if (damage > 0) {
+            // Шанс на критический удар (20%)
+            bool critical = battle.rng.chance(20);
+            if (critical) {
+                damage *= 2;
+            }
+            target.takeDamage(damage);
+            if (battle.out) {
+                *battle.out << (critical ? "Critical hit! " : "")
+                    << name << " attacks " << target.getName() << " for " << damage << " damage!\n";
+            }
+        }
+        else if (battle.out) {
+            *battle.out << name << " attacks " << target.getName() << ", but it has no effect!\n";
+        }
+    }
+
+    // Переопределение метода writeInfo
+    void writeInfo(text::Buffer& out) const override {
+        out << "Character: " << name.view() << ", HP: " << health
+            << ", Attack: " << attack << ", Defense: " << defense << '\n';
+    }
+
+    EntityKind getKind() const override { return EntityKind::Character; }
+
+    // Переопределение метода heal
+    void heal(int amount, BattleContext& battle) override {
+        health += amount;
+        if (battle.out) {
+            *battle.out << name << " uses healing spell and restores " << amount << " HP. Current HP: " << health << '\n';
+        }
+    }
+};
+
+class Monster : public Entity {
+public:
+    // Ядовитая атака: poisonDamage урона в каждый из следующих poisonTurns ходов
+    static constexpr int poisonDamage = 1;
+    static constexpr uint32_t poisonTurns = 5;
+
+    Monster(const std::string& n, int h, int a, int d)
+        : Entity(n, h, a, d) {
+    }
+
+    // Переопределение метода attack
+    void attackEnemy(Entity& target, BattleContext& battle) override {
+        int damage = attack - target.getDefence();
+        if (damage > 0) {
+            // Шанс на ядовитую атаку (30%)
+            bool poisonous = battle.rng.chance(30);
+            target.takeDamage(damage);
+            if (battle.out) {
+                *battle.out << (poisonous ? "Poisonous attack! " : "")
+                    << name << " attacks " << target.getName() << " for " << damage << " damage!\n";
+            }
+            if (poisonous) {
+                poison(target, battle);
+            }
+        }
+        else if (battle.out) {
+            *battle.out << name << " attacks " << target.getName() << ", but it has no effect!\n";
+        }
+    }
+
+    // Переопределение метода writeInfo
+    void writeInfo(text::Buffer& out) const override {
+        out << "Monster: " << name.view() << ", HP: " << health
+            << ", Attack: " << attack << ", Defense: " << defense << '\n';
+    }
+
+    EntityKind getKind() const override { return EntityKind::Monster; }
+
+protected:
+    // Вешает на цель яд (определена после StatusEffects)
+    static void poison(Entity& target, BattleContext& battle);
+};
+
+class Boss : public Monster {
+public:
+    Boss(const std::string& n, int h, int a, int d) : Monster(n, h, a, d) {}
+
+    void FireStrike(Entity& target, BattleContext& battle) {
+        int damage = attack - target.getDefence();
+        if (damage > 0) {
+            // Шанс на ядовитую атаку (30%)
+            bool poisonous = battle.rng.chance(30);
+            target.takeDamage(damage);
+            if (battle.out) {
+                *battle.out << (poisonous ? "Poisonous attack! " : "")
+                    << name << " attacks by Fire Strike " << target.getName() << " for " << damage << " damage!\n";
+            }
+            if (poisonous) {
+                poison(target, battle);
+            }
+        }
+        else if (battle.out) {
+            *battle.out << name << " attacks " << target.getName() << ", but enemy is Dodged!\n";
+        }
+    }
+
+    EntityKind getKind() const override { return EntityKind::Boss; }
+};
+
+// Периодические эффекты на существах
+enum class EffectType : uint8_t { Poison, Burn, Regen, DefenseBuff };
+
+struct StatusEffect {
+    EffectType type;
+    Entity* target;
+    int amount;       // Урон или лечение за срабатывание, для DefenseBuff - прибавка к защите
+    uint32_t period;  // Тиков между срабатываниями, для DefenseBuff - длительность
+    uint32_t charges; // Сколько раз сработает (DefenseBuff снимается один раз)
+};
+
+// Ссылка на запланированный эффект: индекс и поколение записи (как EntityHandle в lb6/lb7).
+// После срабатывания или отмены ссылка перестаёт действовать, даже если запись занята заново
+struct EffectHandle {
+    uint32_t index = 0;
+    uint32_t generation = 0;
+};
+
+// Иерархическое колесо таймеров для эффектов.
+// 4 уровня по 256 ячеек: на уровне k лежат эффекты, до срабатывания которых меньше 256^(k+1) тиков.
+// Когда младший уровень делает полный оборот, ячейка старшего раскладывается по младшим уровням.
+// Эффекты одной ячейки связаны двусвязным списком по индексам записей, поэтому добавление
+// и отмена выполняются за O(1). Все эффекты тика применяются одним проходом по его ячейке.
+// Эффект хранит указатель на существо, поэтому перед удалением существа его эффекты нужно отменить
+class StatusEffects {
+public:
+    EffectHandle add(const StatusEffect& effect) {
+        if (!effect.target) {
+            throw std::invalid_argument("Status effect needs a target");
+        }
+        if (effect.period == 0 || (effect.charges == 0 && effect.type != EffectType::DefenseBuff)) {
+            throw std::invalid_argument("Status effect must fire at least once after a positive period");
+        }
+
+        uint32_t index = allocate();
+        timers[index].effect = effect;
+        if (effect.type == EffectType::DefenseBuff) {
+            effect.target->changeDefense(effect.amount);
+        }
+        link(index, now + effect.period);
+
+        EffectHandle handle;
+        handle.index = index;
+        handle.generation = timers[index].generation;
+        return handle;
+    }
+
+    // Отмена до срабатывания; усиление защиты при этом снимается сразу
+    bool cancel(EffectHandle handle) {
+        if (!contains(handle)) {
+            return false;
+        }
+        Timer& timer = timers[handle.index];
+        if (timer.effect.type == EffectType::DefenseBuff) {
+            timer.effect.target->changeDefense(-timer.effect.amount);
+        }
+        unlink(handle.index);
+        release(handle.index);
+        return true;
+    }
+
+    bool contains(EffectHandle handle) const {
+        return handle.index < timers.size() && timers[handle.index].list != npos
+            && timers[handle.index].generation == handle.generation;
+    }
+
+    // Продвигает время на ticks тиков и применяет сработавшие эффекты
+    void advance(uint64_t ticks, BattleContext& battle) {
+        for (uint64_t i = 0; i < ticks; ++i) {
+            step(battle);
+        }
+    }
+
+    uint64_t getTime() const { return now; }
+    size_t size() const { return active; }
+
+private:
+    static constexpr int levelBits = 8;
+    static constexpr uint32_t slotsPerLevel = 1u << levelBits;
+    static constexpr int levels = 4;
+    static constexpr uint32_t npos = UINT32_MAX;
+
+    struct Timer {
+        StatusEffect effect;
+        uint64_t expires = 0;
+        uint32_t prev = npos;
+        uint32_t next = npos;
+        uint32_t list = npos; // Ячейка: уровень * slotsPerLevel + номер; npos - запись свободна
+        uint32_t generation = 1;
+    };
+
+    uint32_t allocate() {
+        uint32_t index;
+        if (!freeTimers.empty()) {
+            index = freeTimers.back();
+            freeTimers.pop_back();
+        }
+        else {
+            if (timers.size() == npos) {
+                throw std::length_error("Too many status effects");
+            }
+            index = static_cast<uint32_t>(timers.size());
+            timers.emplace_back();
+        }
+        ++active;
+        return index;
+    }
+
+    void release(uint32_t index) {
+        Timer& timer = timers[index];
+        timer.list = npos;
+        if (++timer.generation == 0) {
+            timer.generation = 1;
+        }
+        freeTimers.push_back(index);
+        --active;
+    }
+
+    void link(uint32_t index, uint64_t expires) {
+        uint64_t delta = expires - now;
+        int level = 0;
+        while (level + 1 < levels && delta >= (uint64_t(1) << (levelBits * (level + 1)))) {
+            ++level;
+        }
+        uint32_t list = level * slotsPerLevel + static_cast<uint32_t>((expires >> (levelBits * level)) & (slotsPerLevel - 1));
+
+        Timer& timer = timers[index];
+        timer.expires = expires;
+        timer.list = list;
+        timer.prev = npos;
+        timer.next = heads[list];
+        if (heads[list] != npos) {
+            timers[heads[list]].prev = index;
+        }
+        heads[list] = index;
+    }
+
+    void unlink(uint32_t index) {
+        Timer& timer = timers[index];
+        if (timer.prev != npos) {
+            timers[timer.prev].next = timer.next;
+        }
+        else {
+            heads[timer.list] = timer.next;
+        }
+        if (timer.next != npos) {
+            timers[timer.next].prev = timer.prev;
+        }
+    }
+
+    // Забирает весь список ячейки, возвращает его первую запись
+    uint32_t detach(uint32_t list) {
+        uint32_t first = heads[list];
+        heads[list] = npos;
+        return first;
+    }
+
+    void step(BattleContext& battle) {
+        ++now;
+
+        // Раскладка старших уровней, начиная с самого старшего: эффекты из него
+        // могут попасть в ячейку следующего уровня, которую разложат сразу после
+        int top = 0;
+        while (top + 1 < levels && (now & ((uint64_t(1) << (levelBits * (top + 1))) - 1)) == 0) {
+            ++top;
+        }
+        for (int level = top; level > 0; --level) {
+            uint32_t list = level * slotsPerLevel + static_cast<uint32_t>((now >> (levelBits * level)) & (slotsPerLevel - 1));
+            for (uint32_t index = detach(list); index != npos;) {
+                uint32_t next = timers[index].next;
+                link(index, timers[index].expires);
+                index = next;
+            }
+        }
+
+        for (uint32_t index = detach(static_cast<uint32_t>(now & (slotsPerLevel - 1))); index != npos;) {
+            uint32_t next = timers[index].next;
+            fire(index, battle);
+            index = next;
+        }
+    }
+
+    void fire(uint32_t index, BattleContext& battle) {
+        StatusEffect& effect = timers[index].effect;
+        switch (effect.type) {
+        case EffectType::Poison:
+        case EffectType::Burn:
+            effect.target->takeDamage(effect.amount);
+            if (battle.out) {
+                *battle.out << effect.target->getName() << " takes " << effect.amount
+                    << (effect.type == EffectType::Poison ? " poison" : " burn") << " damage\n";
+            }
+            break;
+        case EffectType::Regen:
+            effect.target->heal(effect.amount, battle);
+            break;
+        case EffectType::DefenseBuff:
+            effect.target->changeDefense(-effect.amount);
+            if (battle.out) {
+                *battle.out << effect.target->getName() << "'s defense buff wears off\n";
+            }
+            release(index);
+            return;
+        }
+
+        if (--effect.charges > 0) {
+            link(index, now + effect.period);
+        }
+        else {
+            release(index);
+        }
+    }
+
+    std::vector<Timer> timers;
+    std::vector<uint32_t> freeTimers;
+    std::vector<uint32_t> heads = std::vector<uint32_t>(levels * slotsPerLevel, npos);
+    uint64_t now = 0;
+    size_t active = 0;
+};
+
+// Яд действует через колесо эффектов боя: урон приходит в следующие ходы, а не сразу
+void Monster::poison(Entity& target, BattleContext& battle) {
+    if (!battle.effects) {
+        return;
+    }
+    battle.effects->add({ EffectType::Poison, &target, poisonDamage, 1, poisonTurns });
+    if (battle.out) {
+        *battle.out << target.getName() << " is poisoned for " << poisonTurns << " turns\n";
+    }
+}
+
+// Запись боя: seed генератора, участники в начале боя и действия по порядку.
+// Исход боя полностью определяется записью, поэтому его можно повторить где угодно
+struct EntitySnapshot {
+    EntityKind kind;
+    std::string name;
+    int health;
+    int attack;
+    int defense;
+};
+
+enum class ActionType : uint8_t { Attack, FireStrike, Heal };
+
+struct BattleAction {
+    ActionType type;
+    uint8_t actor;  // Номер участника
+    uint8_t target; // Номер цели (для лечения не используется)
+    int32_t amount; // Сила лечения
+};
+
+struct BattleRecord {
+    uint64_t seed = 0;
+    std::vector<EntitySnapshot> entities;
+    std::vector<BattleAction> actions;
+};
+
+std::unique_ptr<Entity> makeEntity(const EntitySnapshot& snapshot) {
+    switch (snapshot.kind) {
+    case EntityKind::Entity:
+        return std::make_unique<Entity>(snapshot.name, snapshot.health, snapshot.attack, snapshot.defense);
+    case EntityKind::Character:
+        return std::make_unique<Character>(snapshot.name, snapshot.health, snapshot.attack, snapshot.defense);
+    case EntityKind::Monster:
+        return std::make_unique<Monster>(snapshot.name, snapshot.health, snapshot.attack, snapshot.defense);
+    case EntityKind::Boss:
+        return std::make_unique<Boss>(snapshot.name, snapshot.health, snapshot.attack, snapshot.defense);
+    }
+    throw std::runtime_error("Unknown entity kind in battle record");
+}
+
+// Выполняет действие записи над участниками; общий код для живого боя и повтора.
+// Каждое действие - один ход: после него срабатывают периодические эффекты этого хода
+void applyAction(const BattleAction& action, const std::vector<Entity*>& entities, BattleContext& battle) {
+    if (action.actor >= entities.size() || action.target >= entities.size()) {
+        throw std::runtime_error("Battle action refers to a missing entity");
+    }
+    Entity& actor = *entities[action.actor];
+    switch (action.type) {
+    case ActionType::Attack:
+        actor.attackEnemy(*entities[action.target], battle);
+        break;
+    case ActionType::FireStrike:
+        if (actor.getKind() != EntityKind::Boss) {
+            throw std::runtime_error("Only a boss can use Fire Strike");
+        }
+        static_cast<Boss&>(actor).FireStrike(*entities[action.target], battle);
+        break;
+    case ActionType::Heal:
+        actor.heal(action.amount, battle);
+        break;
+    default:
+        throw std::runtime_error("Unknown battle action");
+    }
+    if (battle.effects) {
+        battle.effects->advance(1, battle);
+    }
+}
+
+// Бой с записью: действия выполняются через Battle и сразу попадают в запись
+class Battle {
+public:
+    Battle(const std::vector<Entity*>& participants, uint64_t seed, std::ostream* out = &std::cout)
+        : entities(participants) {
+        if (entities.size() > UINT8_MAX + 1u) {
+            throw std::invalid_argument("Too many battle participants");
+        }
+        context.rng.setState(seed);
+        context.effects = &effects;
+        context.out = out;
+        record.seed = seed;
+        for (const Entity* entity : entities) {
+            record.entities.push_back({ entity->getKind(), std::string(entity->getName()),
+                entity->getHealth(), entity->getAttack(), entity->getDefence() });
+        }
+    }
+
+    // Контекст ссылается на эффекты этого объекта
+    Battle(const Battle&) = delete;
+    Battle& operator=(const Battle&) = delete;
+
+    void attack(Entity& attacker, Entity& target) {
+        perform({ ActionType::Attack, indexOf(attacker), indexOf(target), 0 });
+    }
+
+    void fireStrike(Boss& boss, Entity& target) {
+        perform({ ActionType::FireStrike, indexOf(boss), indexOf(target), 0 });
+    }
+
+    void heal(Entity& entity, int amount) {
+        perform({ ActionType::Heal, indexOf(entity), 0, amount });
+    }
+
+    const BattleRecord& getRecord() const { return record; }
+
+private:
+    uint8_t indexOf(const Entity& entity) const {
+        auto it = std::find(entities.begin(), entities.end(), &entity);
+        if (it == entities.end()) {
+            throw std::invalid_argument(std::string(entity.getName()) + " does not take part in the battle");
+        }
+        return static_cast<uint8_t>(it - entities.begin());
+    }
+
+    void perform(const BattleAction& action) {
+        applyAction(action, entities, context);
+        record.actions.push_back(action);
+    }
+
+    std::vector<Entity*> entities;
+    StatusEffects effects;
+    BattleContext context;
+    BattleRecord record;
+};
+
+// Повтор записи без вывода. seek(n) даёт состояние после первых n действий.
+// По пути каждые checkpointInterval действий запоминается контрольная точка (здоровье и защита
+// всех участников, состояние генератора и действующие эффекты), поэтому переход назад или повторный переход вперёд
+// начинается с ближайшей точки, а не с начала боя. Запись хранится внутри повтора,
+// так что повтор можно строить и из временного объекта
+class BattleReplay {
+public:
+    static constexpr size_t checkpointInterval = 256;
+
+    explicit BattleReplay(BattleRecord battleRecord) : record(std::move(battleRecord)) {
+        for (const auto& snapshot : record.entities) {
+            owned.push_back(makeEntity(snapshot));
+            entities.push_back(owned.back().get());
+        }
+        context.effects = &effects;
+        context.out = nullptr;
+        restore(startCheckpoint());
+    }
+
+    BattleReplay(const BattleReplay&) = delete;
+    BattleReplay& operator=(const BattleReplay&) = delete;
+
+    void seek(size_t turn) {
+        if (turn > record.actions.size()) {
+            throw std::out_of_range("Battle record has only " + std::to_string(record.actions.size()) + " actions");
+        }
+
+        // Контрольные точки идут по возрастанию хода, checkpoints[i] - после (i + 1) * checkpointInterval действий
+        size_t known = std::min(turn / checkpointInterval, checkpoints.size());
+        size_t nearest = known * checkpointInterval;
+        if (turn < position || nearest > position) {
+            restore(known == 0 ? startCheckpoint() : checkpoints[known - 1]);
+        }
+
+        while (position < turn) {
+            applyAction(record.actions[position], entities, context);
+            ++position;
+            if (position % checkpointInterval == 0 && position / checkpointInterval > checkpoints.size()) {
+                checkpoints.push_back(capture());
+            }
+        }
+    }
+
+    // Повтор до конца записи
+    void finish() { seek(record.actions.size()); }
+
+    size_t getTurn() const { return position; }
+    const Entity& getEntity(size_t index) const { return *entities.at(index); }
+    size_t getEntityCount() const { return entities.size(); }
+
+private:
+    // Эффекты в точке ссылаются на участников этого же повтора, поэтому их можно просто скопировать
+    struct Checkpoint {
+        size_t turn;
+        uint64_t rngState;
+        std::vector<int> health;
+        std::vector<int> defense;
+        StatusEffects effects;
+    };
+
+    Checkpoint startCheckpoint() const {
+        Checkpoint start{ 0, record.seed, {}, {}, {} };
+        for (const auto& snapshot : record.entities) {
+            start.health.push_back(snapshot.health);
+            start.defense.push_back(snapshot.defense);
+        }
+        return start;
+    }
+
+    Checkpoint capture() const {
+        Checkpoint checkpoint{ position, context.rng.getState(), {}, {}, effects };
+        for (const Entity* entity : entities) {
+            checkpoint.health.push_back(entity->getHealth());
+            checkpoint.defense.push_back(entity->getDefence());
+        }
+        return checkpoint;
+    }
+
+    void restore(const Checkpoint& checkpoint) {
+        for (size_t i = 0; i < entities.size(); ++i) {
+            entities[i]->restoreHealth(checkpoint.health[i]);
+            entities[i]->restoreDefense(checkpoint.defense[i]);
+        }
+        context.rng.setState(checkpoint.rngState);
+        effects = checkpoint.effects;
+        position = checkpoint.turn;
+    }
+
+    BattleRecord record;
+    std::vector<std::unique_ptr<Entity>> owned;
+    std::vector<Entity*> entities;
+    StatusEffects effects;
+    BattleContext context;
+    std::vector<Checkpoint> checkpoints;
+    size_t position = 0;
+};
+
+// Файл записи (все числа little-endian): "LB1R", версия, seed, число участников,
+// участники (тип, длина имени, имя, здоровье, атака, защита), число действий,
+// действия (тип, участник, цель, сила) по 7 байт
+template<typename T>
+void writeLE(std::ostream& out, T value) {
+    char bytes[sizeof(T)];
+    for (size_t i = 0; i < sizeof(T); ++i) {
+        bytes[i] = static_cast<char>(static_cast<uint64_t>(value) >> (8 * i));
+    }
+    out.write(bytes, sizeof(T));
+}
+
+template<typename T>
+T readLE(std::istream& in) {
+    unsigned char bytes[sizeof(T)];
+    if (!in.read(reinterpret_cast<char*>(bytes), sizeof(T))) {
+        throw std::runtime_error("Battle record is truncated");
+    }
+    uint64_t value = 0;
+    for (size_t i = 0; i < sizeof(T); ++i) {
+        value |= static_cast<uint64_t>(bytes[i]) << (8 * i);
+    }
+    return static_cast<T>(value);
+}
+
+const char battleRecordMagic[4] = { 'L', 'B', '1', 'R' };
+const uint32_t battleRecordVersion = 1;
+
+void saveBattleRecord(const BattleRecord& record, const std::string& filename) {
+    std::ofstream out(filename, std::ios::binary);
+    if (!out) {
+        throw std::runtime_error("Failed to open battle record for writing");
+    }
+
+    out.write(battleRecordMagic, sizeof(battleRecordMagic));
+    writeLE<uint32_t>(out, battleRecordVersion);
+    writeLE<uint64_t>(out, record.seed);
+    writeLE<uint32_t>(out, static_cast<uint32_t>(record.entities.size()));
+    for (const auto& entity : record.entities) {
+        writeLE<uint8_t>(out, static_cast<uint8_t>(entity.kind));
+        writeLE<uint32_t>(out, static_cast<uint32_t>(entity.name.size()));
+        out.write(entity.name.data(), entity.name.size());
+        writeLE<int32_t>(out, entity.health);
+        writeLE<int32_t>(out, entity.attack);
+        writeLE<int32_t>(out, entity.defense);
+    }
+    writeLE<uint32_t>(out, static_cast<uint32_t>(record.actions.size()));
+    for (const auto& action : record.actions) {
+        writeLE<uint8_t>(out, static_cast<uint8_t>(action.type));
+        writeLE<uint8_t>(out, action.actor);
+        writeLE<uint8_t>(out, action.target);
+        writeLE<int32_t>(out, action.amount);
+    }
+
+    if (!out) {
+        throw std::runtime_error("Failed to write battle record");
+    }
+}
+
+BattleRecord loadBattleRecord(const std::string& filename) {
+    std::ifstream in(filename, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("Failed to open battle record");
+    }
+
+    char magic[sizeof(battleRecordMagic)];
+    if (!in.read(magic, sizeof(magic)) || !std::equal(magic, magic + sizeof(magic), battleRecordMagic)) {
+        throw std::runtime_error("Not a battle record");
+    }
+    if (readLE<uint32_t>(in) != battleRecordVersion) {
+        throw std::runtime_error("Unsupported battle record version");
+    }
+
+    BattleRecord record;
+    record.seed = readLE<uint64_t>(in);
+    uint32_t entityCount = readLE<uint32_t>(in);
+    if (entityCount > UINT8_MAX + 1u) {
+        throw std::runtime_error("Battle record is corrupted");
+    }
+    for (uint32_t i = 0; i < entityCount; ++i) {
+        EntitySnapshot entity;
+        uint8_t kind = readLE<uint8_t>(in);
+        if (kind > static_cast<uint8_t>(EntityKind::Boss)) {
+            throw std::runtime_error("Unknown entity kind in battle record");
+        }
+        entity.kind = static_cast<EntityKind>(kind);
+        uint32_t nameSize = readLE<uint32_t>(in);
+        if (nameSize > 1024) {
+            throw std::runtime_error("Battle record is corrupted");
+        }
+        entity.name.resize(nameSize);
+        if (!in.read(&entity.name[0], nameSize)) {
+            throw std::runtime_error("Battle record is truncated");
+        }
+        entity.health = readLE<int32_t>(in);
+        entity.attack = readLE<int32_t>(in);
+        entity.defense = readLE<int32_t>(in);
+        record.entities.push_back(entity);
+    }
+
+    uint32_t actionCount = readLE<uint32_t>(in);
+    for (uint32_t i = 0; i < actionCount; ++i) {
+        BattleAction action;
+        uint8_t type = readLE<uint8_t>(in);
+        if (type > static_cast<uint8_t>(ActionType::Heal)) {
+            throw std::runtime_error("Unknown battle action");
+        }
+        action.type = static_cast<ActionType>(type);
+        action.actor = readLE<uint8_t>(in);
+        action.target = readLE<uint8_t>(in);
+        action.amount = readLE<int32_t>(in);
+        record.actions.push_back(action);
+    }
+    return record;
+}
+
+int main() {
+    try {
+        // Seed сохраняется в записи боя, поэтому бой можно повторить
+        uint64_t seed = static_cast<uint64_t>(time(0));
+
+        // Создание объектов
+        Character hero("Hero", 100, 20, 10);
+        Monster goblin("Goblin", 50, 15, 5);
+        Monster dragon("Dragon", 150, 25, 20);
+        Boss boss("Bob", 200, 50, 40);
+
+        // Массив указателей на базовый класс
+        Entity* entities[] = { &hero, &goblin, &dragon, &boss };
+
+        // Полиморфное поведение: описания собираются в один буфер и выводятся одной записью
+        text::Buffer info;
+        for (auto& entity : entities) {
+            entity->writeInfo(info); // Запись информации о сущности
+        }
+        info.flushTo(std::cout);
+
+        // Бой между персонажем и монстрами
+        Battle battle({ std::begin(entities), std::end(entities) }, seed);
+        battle.attack(hero, goblin);
+        battle.attack(goblin, hero);
+        battle.attack(dragon, hero);
+        battle.attack(boss, hero);
+        battle.fireStrike(boss, hero);
+
+        // Персонаж лечится
+        battle.heal(hero, 30);
+
+        // Запись боя сохраняется и повторяется без вывода
+        saveBattleRecord(battle.getRecord(), "battle_record.bin");
+        BattleReplay replay(loadBattleRecord("battle_record.bin"));
+        replay.seek(3);
+        std::cout << "\nReplay after 3 actions: " << replay.getEntity(0).getName()
+            << " HP " << replay.getEntity(0).getHealth() << "\n";
+        replay.finish();
+        std::cout << "Replay matches the battle: "
+            << (replay.getEntity(0).getHealth() == hero.getHealth() ? "yes" : "no") << "\n";
+
+        // Периодические эффекты: яд, горение, регенерация и временная защита
+        std::cout << "\n=== Status Effects ===\n";
+        BattleContext effectContext;
+        StatusEffects effects;
+        effects.add({ EffectType::Poison, &goblin, 3, 2, 3 }); // 3 урона каждые 2 тика, трижды
+        effects.add({ EffectType::Regen, &hero, 5, 1, 4 });
+        effects.add({ EffectType::DefenseBuff, &hero, 10, 5, 1 });
+        EffectHandle burn = effects.add({ EffectType::Burn, &dragon, 4, 1, 100 });
+        effects.advance(3, effectContext);
+        effects.cancel(burn); // Дракона потушили
+        effects.advance(4, effectContext);
+        goblin.displayInfo();
+        dragon.displayInfo();
+        hero.displayInfo();
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -1,327 +1,476 @@
-﻿#include <iostream>
-#include <string>
-#include <vector>
-#include <memory>
-#include <fstream>
-#include <algorithm>
-#include <stdexcept>
-
-// Исключения
-class InvalidInputException : public std::runtime_error {
-public:
-    InvalidInputException(const std::string& msg) : std::runtime_error(msg) {}
-};
-
-class FileException : public std::runtime_error {
-public:
-    FileException(const std::string& msg) : std::runtime_error(msg) {}
-};
-
-class User {
-protected:
-    std::string name;
-    int id;
-    int accessLevel;
-
-    void validate() const {
-        if (name.empty()) throw InvalidInputException("User name cannot be empty");
-        if (id < 0) throw InvalidInputException("User ID cannot be negative");
-        if (accessLevel < 0) throw InvalidInputException("Access level cannot be negative");
-    }
-
-public:
-    User(const std::string& name, int id, int accessLevel)
-        : name(name), id(id), accessLevel(accessLevel) {
-        validate();
-    }
-
-    virtual void displayInfo() const {
-        std::cout << "Name: " << name << ", ID: " << id
-            << ", Access Level: " << accessLevel;
-    }
-
-    virtual void saveToFile(std::ofstream& out) const {
-        out << "User " << name << " " << id << " " << accessLevel << "\n";
-    }
-
-    std::string getName() const { return name; }
-    int getId() const { return id; }
-    int getAccessLevel() const { return accessLevel; }
-
-    virtual ~User() = default;
-};
-
-class Student : public User {
-private:
-    int group;
-
-public:
-    Student(const std::string& name, int id, int accessLevel, int group)
-        : User(name, id, accessLevel), group(group) {
-    }
-
-    void displayInfo() const override {
-        User::displayInfo();
-        std::cout << ", Group: " << group << " (Student)" << std::endl;
-    }
-
-    void saveToFile(std::ofstream& out) const override {
-        out << "Student " << name << " " << id << " " << accessLevel << " " << group << "\n";
-    }
-};
-
-class Teacher : public User {
-private:
-    std::string department;
-
-public:
-    Teacher(const std::string& name, int id, int accessLevel, const std::string& department)
-        : User(name, id, accessLevel), department(department) {
-    }
-
-    void displayInfo() const override {
-        User::displayInfo();
-        std::cout << ", Department: " << department << " (Teacher)" << std::endl;
-    }
-
-    void saveToFile(std::ofstream& out) const override {
-        out << "Teacher " << name << " " << id << " " << accessLevel << " " << department << "\n";
-    }
-};
-
-class Administrator : public User {
-private:
-    std::string adminKey;
-
-public:
-    Administrator(const std::string& name, int id, int accessLevel, const std::string& key)
-        : User(name, id, accessLevel), adminKey(key) {
-    }
-
-    void displayInfo() const override {
-        User::displayInfo();
-        std::cout << " (Administrator)" << std::endl;
-    }
-
-    void saveToFile(std::ofstream& out) const override {
-        out << "Administrator " << name << " " << id << " " << accessLevel << " " << adminKey << "\n";
-    }
-};
-
-class Resource {
-private:
-    std::string name;
-    int requiredAccessLevel;
-
-    void validate() const {
-        if (name.empty()) throw InvalidInputException("Resource name cannot be empty");
-        if (requiredAccessLevel < 0) throw InvalidInputException("Required access level cannot be negative");
-    }
-
-public:
-    Resource(const std::string& name, int requiredAccessLevel)
-        : name(name), requiredAccessLevel(requiredAccessLevel) {
-        validate();
-    }
-
-    bool checkAccess(const User& user) const {
-        return user.getAccessLevel() >= requiredAccessLevel;
-    }
-
-    void saveToFile(std::ofstream& out) const {
-        out << "Resource " << name << " " << requiredAccessLevel << "\n";
-    }
-
-    std::string getName() const { return name; }
-    int getRequiredAccessLevel() const { return requiredAccessLevel; }
-};
-
-template<typename T>
-class AccessControlSystem {
-private:
-    std::vector<std::unique_ptr<User>> users;
-    std::vector<T> resources;
-
-public:
-    void addUser(std::unique_ptr<User> user) {
-        users.push_back(std::move(user));
-    }
-
-    void addResource(const T& resource) {
-        resources.push_back(resource);
-    }
-
-    bool checkAccess(int userId, const std::string& resourceName) const {
-        auto userIt = std::find_if(users.begin(), users.end(),
-            [userId](const auto& user) { return user->getId() == userId; });
-
-        auto resIt = std::find_if(resources.begin(), resources.end(),
-            [resourceName](const auto& res) { return res.getName() == resourceName; });
-
-        if (userIt == users.end()) throw std::runtime_error("User not found");
-        if (resIt == resources.end()) throw std::runtime_error("Resource not found");
-
-        return resIt->checkAccess(**userIt);
-    }
-
-    void displayAllUsers() const {
-        for (const auto& user : users) {
-            user->displayInfo();
-        }
-    }
-
-    void displayAllResources() const {
-        for (const auto& res : resources) {
-            std::cout << "Resource: " << res.getName()
-                << ", Required Access: " << res.getRequiredAccessLevel() << std::endl;
-        }
-    }
-
-    void saveToFile(const std::string& filename) const {
-        std::ofstream out(filename);
-        if (!out) throw FileException("Cannot open file for writing");
-
-        for (const auto& user : users) {
-            user->saveToFile(out);
-        }
-
-        for (const auto& res : resources) {
-            res.saveToFile(out);
-        }
-    }
-
-    void loadFromFile(const std::string& filename) {
-        std::ifstream in(filename);
-        if (!in) throw FileException("Cannot open file for reading");
-
-        users.clear();
-        resources.clear();
-
-        std::string type;
-        while (in >> type) {
-            if (type == "User") {
-                std::string name;
-                int id, accessLevel;
-                in >> name >> id >> accessLevel;
-                users.push_back(std::make_unique<User>(name, id, accessLevel));
-            }
-            else if (type == "Student") {
-                std::string name;
-                int id, accessLevel, group;
-                in >> name >> id >> accessLevel >> group;
-                users.push_back(std::make_unique<Student>(name, id, accessLevel, group));
-            }
-            else if (type == "Teacher") {
-                std::string name, department;
-                int id, accessLevel;
-                in >> name >> id >> accessLevel >> department;
-                users.push_back(std::make_unique<Teacher>(name, id, accessLevel, department));
-            }
-            else if (type == "Administrator") {
-                std::string name, key;
-                int id, accessLevel;
-                in >> name >> id >> accessLevel >> key;
-                users.push_back(std::make_unique<Administrator>(name, id, accessLevel, key));
-            }
-            else if (type == "Resource") {
-                std::string name;
-                int requiredAccessLevel;
-                in >> name >> requiredAccessLevel;
-                resources.emplace_back(name, requiredAccessLevel);
-            }
-        }
-    }
-
-    std::vector<User*> findUsersByName(const std::string& name) const {
-        std::vector<User*> result;
-        for (const auto& user : users) {
-            if (user->getName() == name) {
-                result.push_back(user.get());
-            }
-        }
-        return result;
-    }
-
-    User* findUserById(int id) const {
-        auto it = std::find_if(users.begin(), users.end(),
-            [id](const auto& user) { return user->getId() == id; });
-        return it != users.end() ? it->get() : nullptr;
-    }
-
-    void sortUsersByAccessLevel() {
-        std::sort(users.begin(), users.end(),
-            [](const auto& a, const auto& b) {
-                return a->getAccessLevel() < b->getAccessLevel();
-            });
-    }
-
-    void sortUsersById() {
-        std::sort(users.begin(), users.end(),
-            [](const auto& a, const auto& b) {
-                return a->getId() < b->getId();
-            });
-    }
-};
-
-int main() {
-    try {
-        AccessControlSystem<Resource> system;
-
-        // Добавление пользователей
-        system.addUser(std::make_unique<Student>("Nick Teran", 1, 1, 101));
-        system.addUser(std::make_unique<Teacher>("Ms. Brown", 2, 3, "Computer Science"));
-        system.addUser(std::make_unique<Administrator>("Mr. Smith", 3, 5, "admin123"));
-
-        // Добавление ресурсов
-        system.addResource(Resource("Classroom 101", 1));
-        system.addResource(Resource("Computer Lab", 3));
-        system.addResource(Resource("Main Library", 2));
-        system.addResource(Resource("Server Room", 5));
-
-        // Демонстрация полиморфизма
-        std::cout << "=== All Users ===" << std::endl;
-        system.displayAllUsers();
-
-        std::cout << "\n=== All Resources ===" << std::endl;
-        system.displayAllResources();
-
-        // Проверка доступа
-        std::cout << "\n=== Access Checks ===" << std::endl;
-        std::cout << "User 1 access to Computer Lab: "
-            << (system.checkAccess(1, "Computer Lab") ? "Granted" : "Denied") << std::endl;
-        std::cout << "User 2 access to Server Room: "
-            << (system.checkAccess(2, "Server Room") ? "Granted" : "Denied") << std::endl;
-
-        // Поиск пользователей
-        std::cout << "\n=== Search ===" << std::endl;
-        auto users = system.findUsersByName("Nick");
-        if (!users.empty()) {
-            std::cout << "Found users with name 'Nick':" << std::endl;
-            for (auto user : users) {
-                user->displayInfo();
-            }
-        }
-
-        // Сортировка
-        std::cout << "\n=== Sorted by Access Level ===" << std::endl;
-        system.sortUsersByAccessLevel();
-        system.displayAllUsers();
-
-        // Файловый ввод-вывод
-        std::cout << "\n=== File I/O ===" << std::endl;
-        system.saveToFile("system_data.txt");
-
-        AccessControlSystem<Resource> newSystem;
-        newSystem.loadFromFile("system_data.txt");
-        std::cout << "Loaded system:" << std::endl;
-        newSystem.displayAllUsers();
-        newSystem.displayAllResources();
-
-    }
-    catch (const std::exception& e) {
-        std::cerr << "Error: " << e.what() << std::endl;
-        return 1;
-    }
-
-    return 0;
-}
\ No newline at end of file
+﻿#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <memory_resource>
+#include <fstream>
+#include <algorithm>
+#include <charconv>
+#include <thread>
+#include <future>
+#include <utility>
+#include <iterator>
+#include <stdexcept>
+
+#include "../../common/mapped_file.h"
+#include "../../common/memory_stats.h"
+#include "../../common/symbols.h"
+#include "../../common/text_buffer.h"
+#include "../../common/trace.h"
+
+// Исключения
+class InvalidInputException : public std::runtime_error {
+public:
+    InvalidInputException(const std::string& msg) : std::runtime_error(msg) {}
+};
+
+class FileException : public std::runtime_error {
+public:
+    FileException(const std::string& msg) : std::runtime_error(msg) {}
+};
+
+class User {
+protected:
+    symbols::Symbol name; // Одинаковые имена хранятся один раз, сравнение - сравнение номеров
+    int id;
+    int accessLevel;
+
+    void validate() const {
+        if (name.empty()) throw InvalidInputException("User name cannot be empty");
+        if (id < 0) throw InvalidInputException("User ID cannot be negative");
+        if (accessLevel < 0) throw InvalidInputException("Access level cannot be negative");
+    }
+
+public:
+    User(const std::string& name, int id, int accessLevel)
+        : name(name), id(id), accessLevel(accessLevel) {
+        validate();
+    }
+
+    // Описание пишется в буфер; displayInfo выводит его в std::cout одной записью
+    virtual void writeInfo(text::Buffer& out) const {
+        out << "Name: " << name.view() << ", ID: " << id
+            << ", Access Level: " << accessLevel;
+    }
+
+    void displayInfo() const {
+        text::Buffer out;
+        writeInfo(out);
+        out.flushTo(std::cout);
+    }
+
+    virtual void saveToFile(std::ofstream& out) const {
+        out << "User " << name << " " << id << " " << accessLevel << "\n";
+    }
+
+    std::string_view getName() const { return name.view(); }
+    symbols::Symbol getNameSymbol() const { return name; }
+    int getId() const { return id; }
+    int getAccessLevel() const { return accessLevel; }
+
+    virtual ~User() = default;
+};
+
+class Student : public User {
+private:
+    int group;
+
+public:
+    Student(const std::string& name, int id, int accessLevel, int group)
+        : User(name, id, accessLevel), group(group) {
+    }
+
+    void writeInfo(text::Buffer& out) const override {
+        User::writeInfo(out);
+        out << ", Group: " << group << " (Student)" << '\n';
+    }
+
+    void saveToFile(std::ofstream& out) const override {
+        out << "Student " << name << " " << id << " " << accessLevel << " " << group << "\n";
+    }
+};
+
+class Teacher : public User {
+private:
+    std::string department;
+
+public:
+    Teacher(const std::string& name, int id, int accessLevel, const std::string& department)
+        : User(name, id, accessLevel), department(department) {
+    }
+
+    void writeInfo(text::Buffer& out) const override {
+        User::writeInfo(out);
+        out << ", Department: " << department << " (Teacher)" << '\n';
+    }
+
+    void saveToFile(std::ofstream& out) const override {
+        out << "Teacher " << name << " " << id << " " << accessLevel << " " << department << "\n";
+    }
+};
+
+class Administrator : public User {
+private:
+    std::string adminKey;
+
+public:
+    Administrator(const std::string& name, int id, int accessLevel, const std::string& key)
+        : User(name, id, accessLevel), adminKey(key) {
+    }
+
+    void writeInfo(text::Buffer& out) const override {
+        User::writeInfo(out);
+        out << " (Administrator)" << '\n';
+    }
+
+    void saveToFile(std::ofstream& out) const override {
+        out << "Administrator " << name << " " << id << " " << accessLevel << " " << adminKey << "\n";
+    }
+};
+
+class Resource {
+private:
+    symbols::Symbol name;
+    int requiredAccessLevel;
+
+    void validate() const {
+        if (name.empty()) throw InvalidInputException("Resource name cannot be empty");
+        if (requiredAccessLevel < 0) throw InvalidInputException("Required access level cannot be negative");
+    }
+
+public:
+    Resource(const std::string& name, int requiredAccessLevel)
+        : name(name), requiredAccessLevel(requiredAccessLevel) {
+        validate();
+    }
+
+    bool checkAccess(const User& user) const {
+        return user.getAccessLevel() >= requiredAccessLevel;
+    }
+
+    void writeInfo(text::Buffer& out) const {
+        out << "Resource: " << name.view() << ", Required Access: " << requiredAccessLevel << '\n';
+    }
+
+    void saveToFile(std::ofstream& out) const {
+        out << "Resource " << name << " " << requiredAccessLevel << "\n";
+    }
+
+    std::string_view getName() const { return name.view(); }
+    symbols::Symbol getNameSymbol() const { return name; }
+    int getRequiredAccessLevel() const { return requiredAccessLevel; }
+};
+
+// Разбор части файла данных системы. Каждая строка: тип записи, имя и числовые поля;
+// имена, отделы и ключи могут содержать пробелы, поэтому границы ищутся по числовым полям
+typedef std::pair<const char*, const char*> Token;
+
+bool parseInt(const Token& token, int& value) {
+    auto result = std::from_chars(token.first, token.second, value);
+    return result.ec == std::errc() && result.ptr == token.second;
+}
+
+std::string joinTokens(const std::vector<Token>& tokens, size_t first, size_t last) {
+    if (first >= last) {
+        throw InvalidInputException("Missing text field in data file");
+    }
+    return std::string(tokens[first].first, tokens[last - 1].second);
+}
+
+template<typename T>
+struct ParsedChunk {
+    std::vector<std::unique_ptr<User>> users;
+    std::vector<T> resources;
+};
+
+template<typename T>
+ParsedChunk<T> parseDataChunk(const char* p, const char* end) {
+    TRACE_SCOPE("parseDataChunk");
+    ParsedChunk<T> chunk;
+    std::vector<Token> tokens;
+
+    while (p != end) {
+        const char* lineEnd = std::find(p, end, '\n');
+        tokens.clear();
+        for (const char* q = mapped::skipSpaces(p, lineEnd); q != lineEnd; q = mapped::skipSpaces(q, lineEnd)) {
+            const char* tokenEnd = mapped::skipToken(q, lineEnd);
+            tokens.emplace_back(q, tokenEnd);
+            q = tokenEnd;
+        }
+        p = (lineEnd == end) ? end : lineEnd + 1;
+        if (tokens.empty()) {
+            continue;
+        }
+
+        std::string type(tokens[0].first, tokens[0].second);
+        size_t n = tokens.size();
+        int id, accessLevel, extra;
+
+        if (type == "User" || type == "Student") {
+            size_t numbers = (type == "User") ? 2 : 3;
+            if (n < numbers + 2 || !parseInt(tokens[n - numbers], id) || !parseInt(tokens[n - numbers + 1], accessLevel)
+                || (numbers == 3 && !parseInt(tokens[n - 1], extra))) {
+                throw InvalidInputException("Invalid " + type + " record in data file");
+            }
+            std::string name = joinTokens(tokens, 1, n - numbers);
+            if (type == "User") {
+                chunk.users.push_back(std::make_unique<User>(name, id, accessLevel));
+            }
+            else {
+                chunk.users.push_back(std::make_unique<Student>(name, id, accessLevel, extra));
+            }
+        }
+        else if (type == "Teacher" || type == "Administrator") {
+            size_t k = 2;
+            while (k + 1 < n && !(parseInt(tokens[k], id) && parseInt(tokens[k + 1], accessLevel))) {
+                ++k;
+            }
+            if (k + 1 >= n) {
+                throw InvalidInputException("Invalid " + type + " record in data file");
+            }
+            std::string name = joinTokens(tokens, 1, k);
+            std::string text = joinTokens(tokens, k + 2, n);
+            if (type == "Teacher") {
+                chunk.users.push_back(std::make_unique<Teacher>(name, id, accessLevel, text));
+            }
+            else {
+                chunk.users.push_back(std::make_unique<Administrator>(name, id, accessLevel, text));
+            }
+        }
+        else if (type == "Resource") {
+            if (n < 3 || !parseInt(tokens[n - 1], accessLevel)) {
+                throw InvalidInputException("Invalid Resource record in data file");
+            }
+            chunk.resources.emplace_back(joinTokens(tokens, 1, n - 1), accessLevel);
+        }
+    }
+    return chunk;
+}
+
+template<typename T>
+class AccessControlSystem {
+private:
+    std::pmr::vector<std::unique_ptr<User>> users;
+    std::pmr::vector<T> resources;
+
+public:
+    // Списки пользователей и ресурсов выделяются из memory,
+    // например из memstats::CountingResource для учёта памяти
+    explicit AccessControlSystem(std::pmr::memory_resource* memory = std::pmr::get_default_resource())
+        : users(memory), resources(memory) {
+    }
+
+    void addUser(std::unique_ptr<User> user) {
+        users.push_back(std::move(user));
+    }
+
+    void addResource(const T& resource) {
+        resources.push_back(resource);
+    }
+
+    bool checkAccess(int userId, std::string_view resourceName) const {
+        TRACE_SCOPE("AccessControlSystem::checkAccess");
+        auto userIt = std::find_if(users.begin(), users.end(),
+            [userId](const auto& user) { return user->getId() == userId; });
+
+        // Имя ищется в таблице символов один раз, дальше сравниваются номера.
+        // Если такого имени нигде нет, нет и ресурса с ним
+        symbols::Symbol wanted;
+        auto resIt = resources.end();
+        if (symbols::find(resourceName, wanted)) {
+            resIt = std::find_if(resources.begin(), resources.end(),
+                [wanted](const auto& res) { return res.getNameSymbol() == wanted; });
+        }
+
+        if (userIt == users.end()) throw std::runtime_error("User not found");
+        if (resIt == resources.end()) throw std::runtime_error("Resource not found");
+
+        return resIt->checkAccess(**userIt);
+    }
+
+    void displayAllUsers(text::Buffer& out) const {
+        for (const auto& user : users) {
+            user->writeInfo(out);
+        }
+    }
+
+    void displayAllResources(text::Buffer& out) const {
+        for (const auto& res : resources) {
+            res.writeInfo(out);
+        }
+    }
+
+    // Текст уходит в std::cout блоками по text::Buffer::blockSize, а не построчно
+    void displayAllUsers() const {
+        text::Buffer out;
+        for (const auto& user : users) {
+            user->writeInfo(out);
+            out.flushIfFull(std::cout);
+        }
+        out.flushTo(std::cout);
+    }
+
+    void displayAllResources() const {
+        text::Buffer out;
+        for (const auto& res : resources) {
+            res.writeInfo(out);
+            out.flushIfFull(std::cout);
+        }
+        out.flushTo(std::cout);
+    }
+
+    void saveToFile(const std::string& filename) const {
+        TRACE_SCOPE("AccessControlSystem::saveToFile");
+        std::ofstream out(filename);
+        if (!out) throw FileException("Cannot open file for writing");
+
+        for (const auto& user : users) {
+            user->saveToFile(out);
+        }
+
+        for (const auto& res : resources) {
+            res.saveToFile(out);
+        }
+    }
+
+    // Файл отображается в память и разбирается частями параллельно;
+    // пользователи и ресурсы добавляются в том порядке, в каком записаны в файле
+    void loadFromFile(const std::string& filename) {
+        TRACE_SCOPE("AccessControlSystem::loadFromFile");
+        mapped::File file;
+        if (!file.open(filename)) {
+            throw FileException("Cannot open file for reading");
+        }
+
+        std::vector<std::future<ParsedChunk<T>>> parts;
+        for (const auto& chunk : mapped::splitByLines(file.data(), file.size())) {
+            parts.push_back(std::async(std::launch::async, parseDataChunk<T>, chunk.first, chunk.second));
+        }
+
+        std::vector<ParsedChunk<T>> results;
+        size_t userCount = 0;
+        size_t resourceCount = 0;
+        for (auto& part : parts) {
+            results.push_back(part.get());
+            userCount += results.back().users.size();
+            resourceCount += results.back().resources.size();
+        }
+
+        users.clear();
+        resources.clear();
+        users.reserve(userCount);
+        resources.reserve(resourceCount);
+        for (auto& result : results) {
+            std::move(result.users.begin(), result.users.end(), std::back_inserter(users));
+            std::move(result.resources.begin(), result.resources.end(), std::back_inserter(resources));
+        }
+    }
+
+    std::vector<User*> findUsersByName(std::string_view name) const {
+        std::vector<User*> result;
+        symbols::Symbol wanted;
+        if (!symbols::find(name, wanted)) {
+            return result;
+        }
+        for (const auto& user : users) {
+            if (user->getNameSymbol() == wanted) {
+                result.push_back(user.get());
+            }
+        }
+        return result;
+    }
+
+    User* findUserById(int id) const {
+        auto it = std::find_if(users.begin(), users.end(),
+            [id](const auto& user) { return user->getId() == id; });
+        return it != users.end() ? it->get() : nullptr;
+    }
+
+    void sortUsersByAccessLevel() {
+        std::sort(users.begin(), users.end(),
+            [](const auto& a, const auto& b) {
+                return a->getAccessLevel() < b->getAccessLevel();
+            });
+    }
+
+    void sortUsersById() {
+        std::sort(users.begin(), users.end(),
+            [](const auto& a, const auto& b) {
+                return a->getId() < b->getId();
+            });
+    }
+};
+
+// Без main файл можно подключить к бенчмаркам (см. bench/)
+#ifndef LB_NO_MAIN
+int main() {
+    try {
+        // Память систем доступа учитывается отдельно и печатается в конце
+        memstats::CountingResource accessMemory(memstats::subsystem("lb10.access"));
+
+        AccessControlSystem<Resource> system(&accessMemory);
+
+        // Добавление пользователей
+        system.addUser(std::make_unique<Student>("Nick Teran", 1, 1, 101));
+        system.addUser(std::make_unique<Teacher>("Ms. Brown", 2, 3, "Computer Science"));
+        system.addUser(std::make_unique<Administrator>("Mr. Smith", 3, 5, "admin123"));
+
+        // Добавление ресурсов
+        system.addResource(Resource("Classroom 101", 1));
+        system.addResource(Resource("Computer Lab", 3));
+        system.addResource(Resource("Main Library", 2));
+        system.addResource(Resource("Server Room", 5));
+
+        // Демонстрация полиморфизма
+        std::cout << "=== All Users ===" << std::endl;
+        system.displayAllUsers();
+
+        std::cout << "\n=== All Resources ===" << std::endl;
+        system.displayAllResources();
+
+        // Проверка доступа
+        std::cout << "\n=== Access Checks ===" << std::endl;
+        std::cout << "User 1 access to Computer Lab: "
+            << (system.checkAccess(1, "Computer Lab") ? "Granted" : "Denied") << std::endl;
+        std::cout << "User 2 access to Server Room: "
+            << (system.checkAccess(2, "Server Room") ? "Granted" : "Denied") << std::endl;
+
+        // Поиск пользователей
+        std::cout << "\n=== Search ===" << std::endl;
+        auto users = system.findUsersByName("Nick");
+        if (!users.empty()) {
+            std::cout << "Found users with name 'Nick':" << std::endl;
+            for (auto user : users) {
+                user->displayInfo();
+            }
+        }
+
+        // Сортировка
+        std::cout << "\n=== Sorted by Access Level ===" << std::endl;
+        system.sortUsersByAccessLevel();
+        system.displayAllUsers();
+
+        // Файловый ввод-вывод
+        std::cout << "\n=== File I/O ===" << std::endl;
+        system.saveToFile("system_data.txt");
+
+        AccessControlSystem<Resource> newSystem(&accessMemory);
+        newSystem.loadFromFile("system_data.txt");
+        std::cout << "Loaded system:" << std::endl;
+        newSystem.displayAllUsers();
+        newSystem.displayAllResources();
+
+        std::cout << "\n=== Memory Usage ===" << std::endl;
+        memstats::report(std::cout);
+
+        TRACE_DUMP("lb10_trace");
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
+#endif // LB_NO_MAIN
\ No newline at end of file
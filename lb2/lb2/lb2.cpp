@@ -1,76 +1,152 @@
-﻿#include <iostream>
-#include <string>
-
-class Character {
-private:
-    std::string name;
-    int health;
-    int attack;
-    int defense;
-
-public:
-    // Конструктор
-    Character(const std::string& n, int h, int a, int d)
-        : name(n), health(h), attack(a), defense(d) {
-        std::cout << "Character " << name << " created!\n";
-    }
-
-    // Деструктор
-    ~Character() {
-        std::cout << "Character " << name << " destroyed!\n";
-    }
-
-    void displayInfo() const {
-        std::cout << "Name: " << name << ", HP: " << health
-            << ", Attack: " << attack << ", Defense: " << defense << std::endl;
-    }
-};
-
-class Monster {
-private:
-    std::string name;
-    int health;
-    int attack;
-    int defense;
-
-public:
-    // Конструктор
-    Monster(const std::string& n, int h, int a, int d)
-        : name(n), health(h), attack(a), defense(d) {
-        std::cout << "Monster " << name << " created!\n";
-    }
-
-    // Деструктор
-    ~Monster() {
-        std::cout << "Monster " << name << " destroyed!\n";
-    }
-
-    void displayInfo() const {
-        std::cout << "Name: " << name << ", HP: " << health
-            << ", Attack: " << attack << ", Defense: " << defense << std::endl;
-    }
-};
-
-class Weapon {
-    std::string name;
-    int damage;
-    int weight;
-
-public:
-    Weapon(const std::string name, int damage, int weight) 
-        : name(name), damage(damage), weight(weight) {}
-
-    void displayInfo() {
-        std::cout << "Name: " << name << "\nDamage: " << damage << "\nWeight: " << weight << std::endl;
-    }
-
-    ~Weapon() {
-        std::cout << name << "is deleted" << std::endl;
-    }
-};
-
-int main() {
-    Weapon ak("Ak-47", 100, 50);
-
-    ak.displayInfo();
+﻿#include <iostream>
+#include <string>
+#include <atomic>
+#include <initializer_list>
+
+// Печать сообщений о создании и удалении объектов. По умолчанию выключена,
+// чтобы создание объектов в цикле не упиралось в вывод в консоль;
+// для отладки соберите с LB2_TRACE_LIFECYCLE=1
+#ifndef LB2_TRACE_LIFECYCLE
+#define LB2_TRACE_LIFECYCLE 0
+#endif
+
+constexpr bool traceLifecycle = LB2_TRACE_LIFECYCLE != 0;
+
+// Счётчики созданных и удалённых объектов одного типа
+struct LifecycleStats {
+    std::atomic<long> created{ 0 };
+    std::atomic<long> destroyed{ 0 };
+};
+
+// Базовый класс, который ведёт счётчики для типа T (включая копии)
+template <typename T>
+class LifecycleCounter {
+public:
+    static LifecycleStats& stats() {
+        static LifecycleStats instance;
+        return instance;
+    }
+
+protected:
+    LifecycleCounter() {
+        stats().created.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    LifecycleCounter(const LifecycleCounter&) : LifecycleCounter() {}
+    LifecycleCounter& operator=(const LifecycleCounter&) = default;
+
+    ~LifecycleCounter() {
+        stats().destroyed.fetch_add(1, std::memory_order_relaxed);
+    }
+};
+
+// Вывод счётчиков для перечисленных типов
+template <typename... Types>
+void dumpLifecycleStats(std::ostream& out) {
+    auto print = [&out](const char* typeName, const LifecycleStats& stats) {
+        long created = stats.created.load(std::memory_order_relaxed);
+        long destroyed = stats.destroyed.load(std::memory_order_relaxed);
+        out << typeName << ": created " << created << ", destroyed " << destroyed
+            << ", live " << created - destroyed << "\n";
+    };
+    (void)std::initializer_list<int>{ (print(Types::typeName(), LifecycleCounter<Types>::stats()), 0)... };
+}
+
+class Character : public LifecycleCounter<Character> {
+private:
+    std::string name;
+    int health;
+    int attack;
+    int defense;
+
+public:
+    static const char* typeName() { return "Character"; }
+
+    // Конструктор
+    Character(const std::string& n, int h, int a, int d)
+        : name(n), health(h), attack(a), defense(d) {
+        if (traceLifecycle) {
+            std::cout << "Character " << name << " created!\n";
+        }
+    }
+
+    // Деструктор
+    ~Character() {
+        if (traceLifecycle) {
+            std::cout << "Character " << name << " destroyed!\n";
+        }
+    }
+
+    void displayInfo() const {
+        std::cout << "Name: " << name << ", HP: " << health
+            << ", Attack: " << attack << ", Defense: " << defense << std::endl;
+    }
+};
+
+class Monster : public LifecycleCounter<Monster> {
+private:
+    std::string name;
+    int health;
+    int attack;
+    int defense;
+
+public:
+    static const char* typeName() { return "Monster"; }
+
+    // Конструктор
+    Monster(const std::string& n, int h, int a, int d)
+        : name(n), health(h), attack(a), defense(d) {
+        if (traceLifecycle) {
+            std::cout << "Monster " << name << " created!\n";
+        }
+    }
+
+    // Деструктор
+    ~Monster() {
+        if (traceLifecycle) {
+            std::cout << "Monster " << name << " destroyed!\n";
+        }
+    }
+
+    void displayInfo() const {
+        std::cout << "Name: " << name << ", HP: " << health
+            << ", Attack: " << attack << ", Defense: " << defense << std::endl;
+    }
+};
+
+class Weapon : public LifecycleCounter<Weapon> {
+    std::string name;
+    int damage;
+    int weight;
+
+public:
+    static const char* typeName() { return "Weapon"; }
+
+    Weapon(const std::string name, int damage, int weight) 
+        : name(name), damage(damage), weight(weight) {}
+
+    void displayInfo() {
+        std::cout << "Name: " << name << "\nDamage: " << damage << "\nWeight: " << weight << std::endl;
+    }
+
+    ~Weapon() {
+        if (traceLifecycle) {
+            std::cout << name << " is deleted" << std::endl;
+        }
+    }
+};
+
+int main() {
+    Weapon ak("Ak-47", 100, 50);
+
+    ak.displayInfo();
+
+    // Массовое создание объектов без вывода в консоль
+    for (int i = 0; i < 100000; ++i) {
+        Monster goblin("Goblin", 50, 15, 5);
+    }
+    Character hero("Hero", 100, 20, 10);
+
+    std::cout << "\nLifecycle stats:\n";
+    dumpLifecycleStats<Character, Monster, Weapon>(std::cout);
 }
\ No newline at end of file
@@ -1,51 +1,348 @@
-﻿#include <iostream>
-
-
-class Weapon {
-    std::string name;
-    int damage;
-    int weight;
-
-public:
-    Weapon(const std::string& name, int damage, int weight) : name(name), damage(damage), weight(weight) {}
-
-    // Геттер
-    int getDamage() const { return damage; }
-
-    void getInfo() {
-        std::cout << "Name: " << name << "\nDamage: " << damage << "\nWeight: " << weight << std::endl;
-    }
-
-    // Перегрузка оператора +
-    Weapon operator+(const Weapon& other) const {
-        return Weapon(name + " & " + other.name, damage + other.damage, weight + other.weight);
-    }
-
-    // Перегрузка оператора >
-    bool operator>(const Weapon& other) const {
-        return damage > other.damage;
-    }
-
-    ~Weapon() {
-        std::cout << "Weapon " << name << " destroyed.\n";
-    }
-};
-
-int main() {
-    Weapon sword("Sword", 10, 5);
-    sword.getInfo();
-    Weapon axe("Axe", 15, 7);
-    axe.getInfo();
-    Weapon mergedWeapon = sword + axe;
-    mergedWeapon.getInfo();
-
-    std::cout << "\nComparing weapons: \n";
-    if (axe > sword) {
-        std::cout << "Axe is stronger than Sword!\n";
-    }
-    else {
-        std::cout << "Sword is stronger than Axe!\n";
-    }
-
-    return 0;
-}
+﻿#include <iostream>
+#include <string>
+#include <vector>
+#include <deque>
+#include <unordered_map>
+#include <cstdint>
+#include <algorithm>
+#include <queue>
+#include <thread>
+#include <random>
+#include <stdexcept>
+#include <mutex>
+#include <shared_mutex>
+
+// Известные сочетания оружия: что получается при слиянии first + second
+struct Recipe {
+    const char* first;
+    const char* second;
+    const char* result;
+};
+
+constexpr Recipe recipes[] = {
+    { "Sword", "Axe", "Battle Axe" },
+    { "Axe", "Sword", "Battle Axe" },
+    { "Sword", "Dagger", "Twin Blades" },
+    { "Dagger", "Sword", "Twin Blades" },
+    { "Bow", "Arrow", "Longbow" },
+    { "Arrow", "Bow", "Longbow" },
+};
+
+// Таблица имён оружия: каждое имя хранится один раз, оружие ссылается на него номером.
+// Таблица общая для всех потоков и защищена std::shared_mutex.
+// Рецепты заполняются в конструкторе и больше не меняются, поэтому читаются без блокировки
+class WeaponNames {
+private:
+    mutable std::shared_mutex mutex;
+    std::deque<std::string> names;
+    std::unordered_map<std::string, uint32_t> ids;
+    std::unordered_map<uint64_t, uint32_t> recipeResults;
+
+    static uint64_t pairKey(uint32_t first, uint32_t second) {
+        return (static_cast<uint64_t>(first) << 32) | second;
+    }
+
+    uint32_t internLocked(const std::string& name) {
+        auto it = ids.find(name);
+        if (it != ids.end()) {
+            return it->second;
+        }
+        uint32_t id = static_cast<uint32_t>(names.size());
+        names.push_back(name);
+        ids.emplace(name, id);
+        return id;
+    }
+
+    WeaponNames() {
+        for (const Recipe& recipe : recipes) {
+            recipeResults[pairKey(internLocked(recipe.first), internLocked(recipe.second))] = internLocked(recipe.result);
+        }
+    }
+
+public:
+    static WeaponNames& instance() {
+        static WeaponNames table;
+        return table;
+    }
+
+    uint32_t intern(const std::string& name) {
+        {
+            std::shared_lock<std::shared_mutex> lock(mutex);
+            auto it = ids.find(name);
+            if (it != ids.end()) {
+                return it->second;
+            }
+        }
+        std::unique_lock<std::shared_mutex> lock(mutex);
+        return internLocked(name);
+    }
+
+    void appendName(uint32_t id, std::string& out) const {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        out += names[id];
+    }
+
+    // Имя результата слияния first + second; false, если такого рецепта нет
+    bool findRecipe(uint32_t first, uint32_t second, uint32_t& result) const {
+        auto it = recipeResults.find(pairKey(first, second));
+        if (it == recipeResults.end()) {
+            return false;
+        }
+        result = it->second;
+        return true;
+    }
+};
+
+// Слияние пары из рецептов даёт готовое имя результата. Остальные слияния строк не создают:
+// номера частей имени копятся в самом оружии, а полное имя "A & B & C" собирается только при выводе.
+// Части освобождаются вместе с оружием, и слияния в разных потоках не ждут друг друга
+class Weapon {
+    uint32_t nameId;
+    std::vector<uint32_t> mergedIds; // Части имени после nameId; у обычного оружия пусто
+    int damage;
+    int weight;
+
+public:
+    Weapon(const std::string& name, int damage, int weight)
+        : nameId(WeaponNames::instance().intern(name)), damage(damage), weight(weight) {}
+
+    // Геттеры
+    int getDamage() const { return damage; }
+
+    std::string getName() const {
+        const WeaponNames& names = WeaponNames::instance();
+        std::string result;
+        names.appendName(nameId, result);
+        for (uint32_t id : mergedIds) {
+            result += " & ";
+            names.appendName(id, result);
+        }
+        return result;
+    }
+
+    void getInfo() const {
+        std::cout << "Name: " << getName() << "\nDamage: " << damage << "\nWeight: " << weight << std::endl;
+    }
+
+    // Слияние с другим оружием на месте
+    Weapon& operator+=(const Weapon& other) {
+        uint32_t recipe;
+        if (mergedIds.empty() && other.mergedIds.empty()
+            && WeaponNames::instance().findRecipe(nameId, other.nameId, recipe)) {
+            nameId = recipe;
+        }
+        else {
+            // Индексы вместо итераторов: other может быть этим же оружием, и push_back перевыделит массив
+            size_t count = other.mergedIds.size();
+            mergedIds.push_back(other.nameId);
+            for (size_t i = 0; i < count; ++i) {
+                mergedIds.push_back(other.mergedIds[i]);
+            }
+        }
+        damage += other.damage;
+        weight += other.weight;
+        return *this;
+    }
+
+    // Перегрузка оператора +: левый операнд берётся по значению,
+    // поэтому в цепочке a + b + c промежуточный результат просто переиспользуется
+    friend Weapon operator+(Weapon lhs, const Weapon& rhs) {
+        lhs += rhs;
+        return lhs;
+    }
+
+    // Перегрузка оператора >
+    bool operator>(const Weapon& other) const {
+        return damage > other.damage;
+    }
+};
+
+// Сравнение для алгоритмов стандартной библиотеки: более сильное оружие идёт первым
+struct Stronger {
+    bool operator()(const Weapon& a, const Weapon& b) const {
+        return a > b;
+    }
+};
+
+// N самых сильных из каталога, от сильного к слабому.
+// nth_element отделяет N лучших за O(n), сортируются только они
+std::vector<Weapon> topWeapons(std::vector<Weapon> catalog, size_t k) {
+    k = std::min(k, catalog.size());
+    std::nth_element(catalog.begin(), catalog.begin() + k, catalog.end(), Stronger());
+    catalog.erase(catalog.begin() + k, catalog.end());
+    std::sort(catalog.begin(), catalog.end(), Stronger());
+    return catalog;
+}
+
+// То же самое для больших каталогов: каждый поток держит кучу из своих N лучших,
+// затем кучи сливаются и из них выбираются общие N лучших
+std::vector<Weapon> topWeaponsParallel(const std::vector<Weapon>& catalog, size_t k, unsigned threadCount) {
+    threadCount = std::max(1u, threadCount);
+    // Вершина такой кучи - самое слабое оружие из уже отобранных
+    typedef std::priority_queue<Weapon, std::vector<Weapon>, Stronger> WorstOnTop;
+    std::vector<WorstOnTop> heaps(threadCount);
+    std::vector<std::thread> threads;
+
+    size_t part = (catalog.size() + threadCount - 1) / threadCount;
+    for (unsigned t = 0; t < threadCount; ++t) {
+        size_t begin = std::min(catalog.size(), t * part);
+        size_t end = std::min(catalog.size(), begin + part);
+        threads.emplace_back([&catalog, &heaps, k, t, begin, end] {
+            WorstOnTop& heap = heaps[t];
+            for (size_t i = begin; i < end; ++i) {
+                if (heap.size() < k) {
+                    heap.push(catalog[i]);
+                }
+                else if (k > 0 && catalog[i] > heap.top()) {
+                    heap.pop();
+                    heap.push(catalog[i]);
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    std::vector<Weapon> candidates;
+    candidates.reserve(k * threadCount);
+    for (auto& heap : heaps) {
+        while (!heap.empty()) {
+            candidates.push_back(heap.top());
+            heap.pop();
+        }
+    }
+    return topWeapons(std::move(candidates), k);
+}
+
+// Рейтинг оружия, который обновляется по мере изменения предметов.
+// Номера оружия хранятся в двоичной куче по operator>, поэтому добавление и изменение
+// стоят O(log n), а N лучших извлекаются за O(N log N) без просмотра всего каталога
+class WeaponRanking {
+private:
+    std::vector<Weapon> weapons;  // Оружие по номеру
+    std::vector<size_t> heap;     // Номера оружия, heap[0] - самое сильное
+    std::vector<size_t> position; // Номер оружия -> позиция в heap
+
+    bool stronger(size_t a, size_t b) const {
+        return weapons[heap[a]] > weapons[heap[b]];
+    }
+
+    void swapNodes(size_t a, size_t b) {
+        std::swap(heap[a], heap[b]);
+        position[heap[a]] = a;
+        position[heap[b]] = b;
+    }
+
+    void siftUp(size_t pos) {
+        while (pos > 0 && stronger(pos, (pos - 1) / 2)) {
+            swapNodes(pos, (pos - 1) / 2);
+            pos = (pos - 1) / 2;
+        }
+    }
+
+    void siftDown(size_t pos) {
+        for (;;) {
+            size_t best = pos;
+            size_t left = 2 * pos + 1;
+            size_t right = left + 1;
+            if (left < heap.size() && stronger(left, best)) best = left;
+            if (right < heap.size() && stronger(right, best)) best = right;
+            if (best == pos) {
+                return;
+            }
+            swapNodes(pos, best);
+            pos = best;
+        }
+    }
+
+public:
+    size_t add(const Weapon& weapon) {
+        size_t id = weapons.size();
+        weapons.push_back(weapon);
+        heap.push_back(id);
+        position.push_back(heap.size() - 1);
+        siftUp(heap.size() - 1);
+        return id;
+    }
+
+    void update(size_t id, const Weapon& weapon) {
+        weapons[id] = weapon;
+        siftUp(position[id]);
+        siftDown(position[id]);
+    }
+
+    const Weapon& get(size_t id) const {
+        return weapons[id];
+    }
+
+    size_t size() const {
+        return weapons.size();
+    }
+
+    // Номера N самых сильных, от сильного к слабому
+    std::vector<size_t> top(size_t k) const {
+        std::vector<size_t> result;
+        auto weaker = [this](size_t a, size_t b) { return weapons[heap[b]] > weapons[heap[a]]; };
+        std::priority_queue<size_t, std::vector<size_t>, decltype(weaker)> frontier(weaker);
+        if (!heap.empty()) {
+            frontier.push(0);
+        }
+        while (result.size() < k && !frontier.empty()) {
+            size_t pos = frontier.top();
+            frontier.pop();
+            result.push_back(heap[pos]);
+            if (2 * pos + 1 < heap.size()) frontier.push(2 * pos + 1);
+            if (2 * pos + 2 < heap.size()) frontier.push(2 * pos + 2);
+        }
+        return result;
+    }
+};
+
+int main() {
+    Weapon sword("Sword", 10, 5);
+    sword.getInfo();
+    Weapon axe("Axe", 15, 7);
+    axe.getInfo();
+    Weapon mergedWeapon = sword + axe;
+    mergedWeapon.getInfo();
+
+    Weapon hammer("Hammer", 20, 12);
+    Weapon chained = sword + axe + hammer;
+    chained.getInfo();
+
+    std::cout << "\nComparing weapons: \n";
+    if (axe > sword) {
+        std::cout << "Axe is stronger than Sword!\n";
+    }
+    else {
+        std::cout << "Sword is stronger than Axe!\n";
+    }
+
+    // Рейтинг большого каталога добычи
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> damageRoll(1, 1000000);
+    std::vector<Weapon> catalog;
+    for (int i = 0; i < 1000000; ++i) {
+        catalog.emplace_back("Loot", damageRoll(rng), 1);
+    }
+
+    std::cout << "\nTop 3 weapons by damage:\n";
+    for (const auto& weapon : topWeapons(catalog, 3)) {
+        std::cout << weapon.getDamage() << "\n";
+    }
+
+    std::cout << "Top 3 weapons by damage (parallel):\n";
+    for (const auto& weapon : topWeaponsParallel(catalog, 3, std::thread::hardware_concurrency())) {
+        std::cout << weapon.getDamage() << "\n";
+    }
+
+    WeaponRanking ranking;
+    ranking.add(sword);
+    size_t axeId = ranking.add(axe);
+    ranking.add(hammer);
+    ranking.update(axeId, axe + hammer);
+    std::cout << "Best in ranking: " << ranking.get(ranking.top(1)[0]).getName() << "\n";
+
+    return 0;
+}
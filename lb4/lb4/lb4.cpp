@@ -1,40 +1,165 @@
-﻿#include <iostream>
-#include <memory>
-#include <string>
-
-class Inventory {
-private:
-    std::unique_ptr<std::string[]> items;
-    size_t capacity;
-    size_t size;
-
-public:
-    Inventory(size_t cap = 10) : capacity(cap), size(0), items(std::make_unique<std::string[]>(cap)) {}
-
-    void addItem(const std::string& item) {
-        if (size < capacity) {
-            items[size++] = item;
-        }
-        else {
-            std::cout << "Inventory is full!" << std::endl;
-        }
-    }
-
-    void displayInventory() const {
-        std::cout << "Inventory items:" << std::endl;
-        for (size_t i = 0; i < size; ++i) {
-            std::cout << "- " << items[i] << std::endl;
-        }
-    }
-};
-
-int main() {
-    Inventory inventory(5);
-    inventory.addItem("Sword");
-    inventory.addItem("Health Potion");
-    inventory.addItem("Shield");
-
-    inventory.displayInventory();
-
-    return 0;
-}
+﻿#include <iostream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <new>
+#include <chrono>
+
+#include "../../common/memory_stats.h"
+
+// Результат добавления предмета
+enum class AddStatus {
+    Added,
+    Full
+};
+
+// Что делать, когда предметы не помещаются в заданную вместимость
+enum class GrowthPolicy {
+    Fixed, // Вместимость не меняется, addItem возвращает AddStatus::Full
+    Grow   // Вместимость удваивается
+};
+
+// Инвентарь с местом под N предметов прямо внутри объекта.
+// Пока предметов не больше N, память в куче не выделяется; дальше предметы переносятся в кучу.
+// Память в куче всех инвентарей учитывается в подсистеме "lb4.inventory"
+template <size_t N>
+class Inventory {
+    static_assert(N > 0, "Inventory needs room for at least one inline item");
+
+public:
+    using Allocator = memstats::CountingAllocator<std::string>;
+
+    static memstats::AllocationStats& memory() {
+        static memstats::AllocationStats& stats = memstats::subsystem("lb4.inventory");
+        return stats;
+    }
+
+private:
+    alignas(std::string) unsigned char inlineStorage[N * sizeof(std::string)];
+    std::string* items;
+    size_t slots;
+    size_t capacity;
+    size_t size;
+    GrowthPolicy policy;
+
+    bool isInline() const {
+        return items == reinterpret_cast<const std::string*>(inlineStorage);
+    }
+
+    void relocate(size_t newSlots) {
+        Allocator allocator(memory());
+        std::string* heap = allocator.allocate(newSlots);
+        for (size_t i = 0; i < size; ++i) {
+            ::new (static_cast<void*>(heap + i)) std::string(std::move(items[i]));
+            items[i].~basic_string();
+        }
+        if (!isInline()) {
+            allocator.deallocate(items, slots);
+        }
+        items = heap;
+        slots = newSlots;
+    }
+
+public:
+    explicit Inventory(size_t cap = N, GrowthPolicy policy = GrowthPolicy::Fixed)
+        : items(reinterpret_cast<std::string*>(inlineStorage)), slots(N), capacity(cap), size(0), policy(policy) {
+    }
+
+    Inventory(const Inventory&) = delete;
+    Inventory& operator=(const Inventory&) = delete;
+
+    ~Inventory() {
+        for (size_t i = 0; i < size; ++i) {
+            items[i].~basic_string();
+        }
+        if (!isInline()) {
+            Allocator(memory()).deallocate(items, slots);
+        }
+    }
+
+    // Создание предмета прямо в инвентаре
+    template <typename... Args>
+    AddStatus emplaceItem(Args&&... args) {
+        if (size == capacity) {
+            if (policy == GrowthPolicy::Fixed) {
+                return AddStatus::Full;
+            }
+            capacity = capacity ? capacity * 2 : 1;
+        }
+        if (size == slots) {
+            size_t newSlots = slots ? slots * 2 : 1;
+            relocate(newSlots < capacity ? newSlots : capacity);
+        }
+        ::new (static_cast<void*>(items + size)) std::string(std::forward<Args>(args)...);
+        ++size;
+        return AddStatus::Added;
+    }
+
+    AddStatus addItem(const std::string& item) {
+        return emplaceItem(item);
+    }
+
+    AddStatus addItem(std::string&& item) {
+        return emplaceItem(std::move(item));
+    }
+
+    size_t getSize() const {
+        return size;
+    }
+
+    size_t getCapacity() const {
+        return capacity;
+    }
+
+    void displayInventory() const {
+        std::cout << "Inventory items:" << std::endl;
+        for (size_t i = 0; i < size; ++i) {
+            std::cout << "- " << items[i] << std::endl;
+        }
+    }
+};
+
+// Замер: сколько выделений памяти делает инвентарь при заполнении (по статистике "lb4.inventory";
+// имена предметов короткие и помещаются в саму строку, поэтому других выделений нет)
+template <size_t N>
+void benchmarkInventory(const char* label, size_t itemsPerInventory, GrowthPolicy policy) {
+    const size_t runs = 100000;
+    const char* names[] = { "Sword", "Health Potion", "Shield", "Bow", "Arrows" };
+
+    memstats::AllocationStats& memory = Inventory<N>::memory();
+    size_t before = memory.allocations();
+    auto start = std::chrono::steady_clock::now();
+    for (size_t run = 0; run < runs; ++run) {
+        Inventory<N> inventory(N, policy);
+        for (size_t i = 0; i < itemsPerInventory; ++i) {
+            inventory.emplaceItem(names[i % 5]);
+        }
+    }
+    auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << label << ": " << static_cast<double>(memory.allocations() - before) / runs
+        << " allocations/inventory, " << elapsed / runs << " ns/inventory" << std::endl;
+}
+
+int main() {
+    Inventory<10> inventory(5);
+    inventory.addItem("Sword");
+    inventory.addItem("Health Potion");
+    inventory.addItem("Shield");
+    inventory.addItem("Bow");
+    inventory.addItem("Arrows");
+    if (inventory.addItem("Helmet") == AddStatus::Full) {
+        std::cout << "Inventory is full!" << std::endl;
+    }
+
+    inventory.displayInventory();
+
+    std::cout << std::endl;
+    benchmarkInventory<20>("20 items, inline storage", 20, GrowthPolicy::Fixed);
+    benchmarkInventory<4>("20 items, heap spill", 20, GrowthPolicy::Grow);
+
+    std::cout << "\nMemory usage:\n";
+    memstats::report(std::cout);
+
+    return 0;
+}
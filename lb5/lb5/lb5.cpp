@@ -1,67 +1,90 @@
-﻿#include <vector>
-#include <iostream>
-#include <memory>
-
-// Базовый класс сущности
-class Entity {
-public:
-    virtual void displayInfo() const = 0;
-    virtual ~Entity() = default;
-};
-
-// Пример класса Player
-class Player : public Entity {
-    std::string name;
-    int health;
-    int score;
-public:
-    Player(const std::string& name, int health, int score)
-        : name(name), health(health), score(score) {
-    }
-    void displayInfo() const override {
-        std::cout << "Player: " << name << ", Health: " << health << ", Score: " << score << '\n';
-    }
-};
-
-// Пример класса Enemy
-class Enemy : public Entity {
-    std::string name;
-    int health;
-    std::string type;
-public:
-    Enemy(const std::string& name, int health, const std::string& type)
-        : name(name), health(health), type(type) {
-    }
-    void displayInfo() const override {
-        std::cout << "Enemy: " << name << ", Health: " << health << ", Type: " << type << '\n';
-    }
-};
-
-// Шаблонный класс очереди
-template <typename T>
-class Queue {
-    std::vector<T> entities;
-public:
-    void addEntity(const T& entity) {
-        entities.push_back(entity);
-    }
-    void popEntity() {
-        if (!entities.empty()) {
-            entities.erase(entities.begin());
-        }
-    }
-    void displayAll() const {
-        for (const auto& entity : entities) {
-            entity->displayInfo();
-        }
-    }
-};
-
-int main() {
-    Queue<std::shared_ptr<Entity>> manager;
-    manager.addEntity(std::make_shared<Player>("Hero", 100, 0));
-    manager.addEntity(std::make_shared<Enemy>("Goblin", 50, "Goblin"));
-    manager.displayAll();
-
-    return 0;
-}
+﻿#include <vector>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "../../common/text_buffer.h"
+
+// Базовый класс сущности
+class Entity {
+public:
+    // Описание пишется в буфер; displayInfo выводит его в std::cout одной записью
+    virtual void writeInfo(text::Buffer& out) const = 0;
+    virtual ~Entity() = default;
+
+    void displayInfo() const {
+        text::Buffer out;
+        writeInfo(out);
+        out.flushTo(std::cout);
+    }
+};
+
+// Пример класса Player
+class Player : public Entity {
+    std::string name;
+    int health;
+    int score;
+public:
+    Player(const std::string& name, int health, int score)
+        : name(name), health(health), score(score) {
+    }
+    void writeInfo(text::Buffer& out) const override {
+        out << "Player: " << name << ", Health: " << health << ", Score: " << score << '\n';
+    }
+};
+
+// Пример класса Enemy
+class Enemy : public Entity {
+    std::string name;
+    int health;
+    std::string type;
+public:
+    Enemy(const std::string& name, int health, const std::string& type)
+        : name(name), health(health), type(type) {
+    }
+    void writeInfo(text::Buffer& out) const override {
+        out << "Enemy: " << name << ", Health: " << health << ", Type: " << type << '\n';
+    }
+};
+
+// Шаблонный класс очереди
+template <typename T>
+class Queue {
+    std::vector<T> entities;
+public:
+    void addEntity(const T& entity) {
+        entities.push_back(entity);
+    }
+    void popEntity() {
+        if (!entities.empty()) {
+            entities.erase(entities.begin());
+        }
+    }
+    void displayAll(text::Buffer& out) const {
+        for (const auto& entity : entities) {
+            entity->writeInfo(out);
+        }
+    }
+
+    // Текст уходит в std::cout блоками по text::Buffer::blockSize, а не построчно
+    void displayAll() const {
+        text::Buffer out;
+        for (const auto& entity : entities) {
+            entity->writeInfo(out);
+            out.flushIfFull(std::cout);
+        }
+        out.flushTo(std::cout);
+    }
+};
+
+// Без main файл можно подключить к бенчмаркам (см. bench/)
+#ifndef LB_NO_MAIN
+int main() {
+    Queue<std::shared_ptr<Entity>> manager;
+    manager.addEntity(std::make_shared<Player>("Hero", 100, 0));
+    manager.addEntity(std::make_shared<Enemy>("Goblin", 50, "Goblin"));
+    manager.displayAll();
+
+    return 0;
+}
+#endif // LB_NO_MAIN
@@ -1,50 +1,415 @@
-﻿#include <iostream>
-#include <vector>
-#include <stdexcept>
-
-// Базовый класс сущности
-class Entity {
-public:
-    virtual int getHealth() const = 0;
-    virtual ~Entity() = default;
-};
-
-// Пример класса Player
-class Player : public Entity {
-    std::string name;
-    int health;
-    int score;
-public:
-    Player(const std::string& name, int health, int score)
-        : name(name), health(health), score(score) {
-    }
-
-    int getHealth() const override {
-        return health;
-    }
-};
-
-// Шаблонный класс GameManager
-template <typename T>
-class GameManager {
-    std::vector<T> entities;
-public:
-    void addEntity(T entity) {
-        if (entity->getHealth() <= 0) {
-            throw std::invalid_argument("Entity has invalid health");
-        }
-        entities.push_back(entity);
-    }
-};
-
-int main() {
-    try {
-        GameManager<Entity*> manager;
-        manager.addEntity(new Player("Hero", -100, 0)); // Вызовет исключение
-    }
-    catch (const std::invalid_argument& e) {
-        std::cerr << "Error: " << e.what() << std::endl;
-    }
-
-    return 0;
-}
+﻿#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <memory>
+#include <unordered_map>
+#include <typeindex>
+#include <utility>
+#include <cstdint>
+#include <stdexcept>
+
+// Базовый класс сущности
+class Entity {
+public:
+    virtual int getHealth() const = 0;
+    virtual ~Entity() = default;
+};
+
+// Пример класса Player
+class Player : public Entity {
+    std::string name;
+    int health;
+    int score;
+public:
+    Player(const std::string& name, int health, int score)
+        : name(name), health(health), score(score) {
+    }
+
+    int getHealth() const override {
+        return health;
+    }
+};
+
+// Общий интерфейс пулов, чтобы GameManager мог хранить пулы разных типов
+class PoolBase {
+public:
+    virtual void destroy(void* object) noexcept = 0;
+    virtual ~PoolBase() = default;
+};
+
+// Пул объектов одного типа: память выделяется блоками, объекты лежат в них подряд
+// и не перемещаются, поэтому указатели на них остаются действительными.
+// Временем жизни объектов управляет GameManager, пул только раздаёт слоты
+template <typename U>
+class ObjectPool : public PoolBase {
+    static const size_t blockSize = 64;
+
+    std::allocator<U> allocator;
+    std::vector<U*> blocks;
+    std::vector<U*> freeSlots; // Слоты удалённых объектов; ёмкость не меньше числа слотов пула
+    size_t used = blockSize;   // Занято слотов в последнем блоке
+
+public:
+    ObjectPool() = default;
+    ObjectPool(const ObjectPool&) = delete;
+    ObjectPool& operator=(const ObjectPool&) = delete;
+
+    // Следующий свободный слот; он считается занятым только после commit()
+    U* nextSlot() {
+        if (!freeSlots.empty()) {
+            return freeSlots.back();
+        }
+        if (used == blockSize) {
+            // Список свободных слотов заранее вмещает все слоты пула, поэтому destroy
+            // не выделяет память и не бросает исключений
+            size_t total = (blocks.size() + 1) * blockSize;
+            if (freeSlots.capacity() < total) {
+                freeSlots.reserve(std::max(total, 2 * freeSlots.capacity()));
+            }
+            U* block = allocator.allocate(blockSize);
+            try {
+                blocks.push_back(block);
+            }
+            catch (...) {
+                allocator.deallocate(block, blockSize);
+                throw;
+            }
+            used = 0;
+        }
+        return blocks.back() + used;
+    }
+
+    // Заранее выделяет блоки, чтобы следующие count объектов не требовали выделений памяти.
+    // Слоты новых блоков попадают в список свободных в порядке адресов
+    void reserve(size_t count) {
+        size_t available = freeSlots.size() + (blockSize - used);
+        if (count <= available) {
+            return;
+        }
+        size_t newBlocks = (count - available + blockSize - 1) / blockSize;
+
+        // Списки готовятся до выделения блоков: push_back ниже не бросает исключений,
+        // а удаление объекта (destroy) тоже не будет выделять память
+        blocks.reserve(blocks.size() + newBlocks);
+        freeSlots.reserve((blocks.size() + newBlocks) * blockSize);
+
+        // nextSlot() берёт слоты из конца последнего блока, а последним станет новый блок,
+        // поэтому незанятый хвост текущего блока переходит в список свободных
+        if (!blocks.empty()) {
+            for (size_t i = blockSize; i > used; --i) {
+                freeSlots.push_back(blocks.back() + i - 1);
+            }
+        }
+        used = blockSize;
+
+        for (size_t b = 0; b < newBlocks; ++b) {
+            U* block = allocator.allocate(blockSize);
+            blocks.push_back(block);
+            for (size_t i = blockSize; i > 0; --i) {
+                freeSlots.push_back(block + i - 1);
+            }
+        }
+    }
+
+    void commit() {
+        if (!freeSlots.empty()) {
+            freeSlots.pop_back();
+        }
+        else {
+            ++used;
+        }
+    }
+
+    void destroy(void* object) noexcept override {
+        U* entity = static_cast<U*>(object);
+        entity->~U();
+        freeSlots.push_back(entity);
+    }
+
+    // Освобождение всей памяти пула разом
+    ~ObjectPool() override {
+        for (U* block : blocks) {
+            allocator.deallocate(block, blockSize);
+        }
+    }
+};
+
+// Ссылка на сущность: индекс слота и его поколение.
+// Ссылка на удалённую сущность перестаёт находить объект, даже если слот занят заново
+struct EntityHandle {
+    uint32_t index = 0;
+    uint32_t generation = 0; // 0 никогда не выдаётся, поэтому handle по умолчанию пустой
+
+    bool operator==(const EntityHandle& other) const {
+        return index == other.index && generation == other.generation;
+    }
+
+    bool operator!=(const EntityHandle& other) const {
+        return !(*this == other);
+    }
+
+    // Упаковка в одно число для сохранения ссылок между сущностями
+    uint64_t toBits() const {
+        return (static_cast<uint64_t>(generation) << 32) | index;
+    }
+
+    static EntityHandle fromBits(uint64_t bits) {
+        EntityHandle handle;
+        handle.index = static_cast<uint32_t>(bits);
+        handle.generation = static_cast<uint32_t>(bits >> 32);
+        return handle;
+    }
+};
+
+// Slot map: вставка, удаление и поиск по EntityHandle за O(1),
+// живые значения лежат в плотном массиве без дыр
+template <typename V>
+class SlotMap {
+    struct Slot {
+        uint32_t dense;      // Позиция значения в values или следующий свободный слот
+        uint32_t generation; // У свободного слота - поколение, которое получит следующая вставка
+        bool occupied;
+    };
+
+    static const uint32_t npos = UINT32_MAX;
+
+    std::vector<V> values;
+    std::vector<uint32_t> owners; // Слот, которому принадлежит values[i]
+    std::vector<Slot> slots;
+    uint32_t freeHead = npos;
+
+public:
+    EntityHandle insert(V value) {
+        // Место под новый элемент готовится заранее, чтобы push_back ниже не бросал исключений.
+        // Ёмкость растёт вдвое: reserve(size() + 1) перевыделял бы массивы на каждой вставке
+        if (values.size() == values.capacity()) {
+            values.reserve(std::max<size_t>(8, 2 * values.size()));
+        }
+        if (owners.size() == owners.capacity()) {
+            owners.reserve(std::max<size_t>(8, 2 * owners.size()));
+        }
+
+        uint32_t index;
+        if (freeHead != npos) {
+            index = freeHead;
+            freeHead = slots[index].dense;
+        }
+        else {
+            if (slots.size() == npos) {
+                throw std::length_error("SlotMap is full");
+            }
+            index = static_cast<uint32_t>(slots.size());
+            slots.push_back({ 0, 1, false });
+        }
+
+        slots[index].dense = static_cast<uint32_t>(values.size());
+        slots[index].occupied = true;
+        values.push_back(std::move(value));
+        owners.push_back(index);
+
+        EntityHandle handle;
+        handle.index = index;
+        handle.generation = slots[index].generation;
+        return handle;
+    }
+
+    V* get(EntityHandle handle) {
+        if (!contains(handle)) {
+            return nullptr;
+        }
+        return &values[slots[handle.index].dense];
+    }
+
+    const V* get(EntityHandle handle) const {
+        if (!contains(handle)) {
+            return nullptr;
+        }
+        return &values[slots[handle.index].dense];
+    }
+
+    bool contains(EntityHandle handle) const {
+        // Свободный слот уже носит поколение следующей вставки, поэтому одного сравнения поколений
+        // мало: handle, собранный через fromBits, совпал бы с ним
+        return handle.index < slots.size() && slots[handle.index].occupied
+            && slots[handle.index].generation == handle.generation;
+    }
+
+    // Удаление перестановкой последнего элемента на место удаляемого
+    bool remove(EntityHandle handle) {
+        if (!contains(handle)) {
+            return false;
+        }
+
+        Slot& slot = slots[handle.index];
+        uint32_t last = static_cast<uint32_t>(values.size() - 1);
+        if (slot.dense != last) {
+            values[slot.dense] = std::move(values[last]);
+            owners[slot.dense] = owners[last];
+            slots[owners[slot.dense]].dense = slot.dense;
+        }
+        values.pop_back();
+        owners.pop_back();
+
+        if (++slot.generation == 0) {
+            slot.generation = 1;
+        }
+        slot.dense = freeHead;
+        slot.occupied = false;
+        freeHead = handle.index;
+        return true;
+    }
+
+    void reserve(size_t count) {
+        values.reserve(count);
+        owners.reserve(count);
+        slots.reserve(count);
+    }
+
+    // Handle для значения с позицией i в плотном массиве
+    EntityHandle handleAt(size_t i) const {
+        EntityHandle handle;
+        handle.index = owners[i];
+        handle.generation = slots[owners[i]].generation;
+        return handle;
+    }
+
+    size_t size() const { return values.size(); }
+    bool empty() const { return values.empty(); }
+
+    typename std::vector<V>::iterator begin() { return values.begin(); }
+    typename std::vector<V>::iterator end() { return values.end(); }
+    typename std::vector<V>::const_iterator begin() const { return values.begin(); }
+    typename std::vector<V>::const_iterator end() const { return values.end(); }
+};
+
+// Шаблонный класс GameManager, владеющий своими сущностями
+template <typename T>
+class GameManager {
+    struct Record {
+        T* entity;
+        void* slot;     // Адрес объекта в пуле его собственного типа
+        PoolBase* pool;
+    };
+
+    std::unordered_map<std::type_index, std::unique_ptr<PoolBase>> pools;
+    SlotMap<Record> registry;
+
+    template <typename U>
+    ObjectPool<U>& poolFor() {
+        auto& pool = pools[std::type_index(typeid(U))];
+        if (!pool) {
+            pool = std::make_unique<ObjectPool<U>>();
+        }
+        return static_cast<ObjectPool<U>&>(*pool);
+    }
+
+public:
+    GameManager() = default;
+    GameManager(const GameManager&) = delete;
+    GameManager& operator=(const GameManager&) = delete;
+
+    ~GameManager() {
+        for (const Record& record : registry) {
+            record.pool->destroy(record.slot);
+        }
+    }
+
+    // Подготовка к созданию count сущностей типа U: после неё create и remove
+    // для них обходятся без выделений памяти
+    template <typename U>
+    void reserve(size_t count) {
+        poolFor<U>().reserve(count);
+        registry.reserve(registry.size() + count);
+    }
+
+    // Создание сущности прямо в пуле; при неверных данных слот не занимается
+    template <typename U, typename... Args>
+    EntityHandle create(Args&&... args) {
+        ObjectPool<U>& pool = poolFor<U>();
+        U* slot = pool.nextSlot();
+        U* entity = ::new (static_cast<void*>(slot)) U(std::forward<Args>(args)...);
+        if (entity->getHealth() <= 0) {
+            entity->~U();
+            throw std::invalid_argument("Entity has invalid health");
+        }
+
+        EntityHandle handle;
+        try {
+            handle = registry.insert({ entity, entity, &pool });
+        }
+        catch (...) {
+            entity->~U();
+            throw;
+        }
+        pool.commit();
+        return handle;
+    }
+
+    // nullptr, если сущность уже удалена
+    T* get(EntityHandle handle) const {
+        const Record* record = registry.get(handle);
+        return record ? record->entity : nullptr;
+    }
+
+    bool remove(EntityHandle handle) {
+        Record* record = registry.get(handle);
+        if (!record) {
+            return false;
+        }
+        record->pool->destroy(record->slot);
+        registry.remove(handle);
+        return true;
+    }
+
+    size_t size() const {
+        return registry.size();
+    }
+
+    // Обход живых сущностей в плотном порядке
+    template <typename F>
+    void forEach(F&& f) const {
+        for (const Record& record : registry) {
+            f(*record.entity);
+        }
+    }
+};
+
+int main() {
+    try {
+        GameManager<Entity> manager;
+        manager.reserve<Player>(16);
+        EntityHandle knight = manager.create<Player>("Knight", 100, 0);
+        manager.remove(knight);
+        manager.create<Player>("Squire", 50, 0); // Займёт освободившийся слот
+        if (manager.get(knight) == nullptr) {
+            std::cout << "Stale handle detected\n";
+        }
+
+        // Handle из сохранения на свободный слот с поколением его следующей вставки
+        EntityHandle scout = manager.create<Player>("Scout", 30, 0);
+        manager.remove(scout);
+        EntityHandle forged = EntityHandle::fromBits(scout.toBits() + (uint64_t(1) << 32));
+        std::cout << "Handle to a free slot rejected: " << (manager.get(forged) == nullptr ? "yes" : "no") << "\n";
+
+        // Резерв при частично занятом блоке: новые сущности не должны попасть в слоты живых
+        GameManager<Entity> squad;
+        squad.create<Player>("Captain", 100, 0);
+        squad.reserve<Player>(200);
+        for (int i = 0; i < 300; ++i) {
+            squad.create<Player>("Recruit", 10, 0);
+        }
+        std::vector<const Entity*> members;
+        squad.forEach([&](const Entity& entity) { members.push_back(&entity); });
+        std::sort(members.begin(), members.end());
+        bool distinct = std::adjacent_find(members.begin(), members.end()) == members.end();
+        std::cout << "Squad of " << squad.size() << " after reserve, slots distinct: "
+            << (distinct ? "yes" : "no") << "\n";
+
+        manager.create<Player>("Hero", -100, 0); // Вызовет исключение
+    }
+    catch (const std::invalid_argument& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+    }
+
+    return 0;
+}
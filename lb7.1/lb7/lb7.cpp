@@ -1,116 +1,724 @@
-﻿#include <iostream>
-#include <fstream>
-#include <vector>
-#include <memory>
-#include <stdexcept>
-
-// Базовый класс сущности
-class Entity {
-public:
-    virtual std::string getName() const = 0;
-    virtual int getHealth() const = 0;
-    virtual int getLevel() const = 0;
-    virtual void displayInfo() const = 0;
-    virtual ~Entity() = default;
-};
-
-// Пример класса Player
-class Player : public Entity {
-    std::string name;
-    int health;
-    int level;
-public:
-    Player(const std::string& name, int health, int level)
-        : name(name), health(health), level(level) {
-    }
-
-    std::string getName() const override {
-        return name;
-    }
-
-    int getHealth() const override {
-        return health;
-    }
-
-    int getLevel() const override {
-        return level;
-    }
-
-    void displayInfo() const override {
-        std::cout << "Player: " << name << ", Health: " << health << ", Level: " << level << '\n';
-    }
-};
-
-// Шаблонный класс GameManager
-template <typename T>
-class GameManager {
-    std::vector<T> entities;
-public:
-    void addEntity(T entity) {
-        entities.push_back(entity);
-    }
-
-    void displayAll() const {
-        for (const auto& entity : entities) {
-            entity->displayInfo();
-        }
-    }
-
-    const std::vector<T>& getEntities() const {
-        return entities;
-    }
-};
-
-// Сохранение данных в файл
-void saveToFile(const GameManager<std::shared_ptr<Entity>>& manager, const std::string& filename) {
-    std::ofstream file(filename);
-    if (!file) {
-        throw std::runtime_error("Failed to open file for writing.");
-    }
-
-    for (const auto& entity : manager.getEntities()) {
-        file << entity->getName() << " " << entity->getHealth() << " " << entity->getLevel() << "\n";
-    }
-}
-
-// Загрузка данных из файла
-void loadFromFile(GameManager<std::shared_ptr<Entity>>& manager, const std::string& filename) {
-    std::ifstream file(filename);
-    if (!file) {
-        throw std::runtime_error("Failed to open file for reading.");
-    }
-
-    std::string name;
-    int health, level;
-
-    while (file >> name >> health >> level) {
-        manager.addEntity(std::make_shared<Player>(name, health, level));
-    }
-}
-
-int main() {
-    try {
-        // Создание менеджера и добавление персонажей
-        GameManager<std::shared_ptr<Entity>> manager;
-        manager.addEntity(std::make_shared<Player>("Hero", 100, 1));
-        manager.addEntity(std::make_shared<Player>("Villain", 50, 2));
-
-        // Сохранение данных в файл
-        saveToFile(manager, "game_save.txt");
-
-        // Создание нового менеджера для загрузки данных
-        GameManager<std::shared_ptr<Entity>> loadedManager;
-
-        // Загрузка данных из файла
-        loadFromFile(loadedManager, "game_save.txt");
-
-        // Отображение загруженных персонажей
-        std::cout << "Loaded Entities:\n";
-        loadedManager.displayAll();
-    }
-    catch (const std::exception& e) {
-        std::cerr << "Error: " << e.what() << std::endl;
-    }
-
-    return 0;
-}
+﻿#include <iostream>
+#include <fstream>
+#include <vector>
+#include <memory>
+#include <memory_resource>
+#include <cstdint>
+#include <cstring>
+#include <charconv>
+#include <algorithm>
+#include <thread>
+#include <future>
+#include <stdexcept>
+#include <string_view>
+
+#include "../../common/mapped_file.h"
+#include "../../common/memory_stats.h"
+#include "../../common/symbols.h"
+#include "../../common/text_buffer.h"
+
+// Базовый класс сущности
+class Entity {
+public:
+    virtual std::string_view getName() const = 0;
+    // Имя в таблице символов: сравнение имён сводится к сравнению номеров
+    virtual symbols::Symbol getNameSymbol() const = 0;
+    virtual int getHealth() const = 0;
+    virtual int getLevel() const = 0;
+    // Описание пишется в буфер; displayInfo выводит его в std::cout одной записью
+    virtual void writeInfo(text::Buffer& out) const = 0;
+    virtual ~Entity() = default;
+
+    void displayInfo() const {
+        text::Buffer out;
+        writeInfo(out);
+        out.flushTo(std::cout);
+    }
+};
+
+// Пример класса Player
+class Player : public Entity {
+    symbols::Symbol name;
+    int health;
+    int level;
+public:
+    Player(const std::string& name, int health, int level)
+        : name(name), health(health), level(level) {
+    }
+
+    std::string_view getName() const override {
+        return name.view();
+    }
+
+    symbols::Symbol getNameSymbol() const override {
+        return name;
+    }
+
+    int getHealth() const override {
+        return health;
+    }
+
+    int getLevel() const override {
+        return level;
+    }
+
+    void writeInfo(text::Buffer& out) const override {
+        out << "Player: " << name.view() << ", Health: " << health << ", Level: " << level << '\n';
+    }
+};
+
+// Ссылка на сущность: индекс слота и его поколение.
+// Ссылка на удалённую сущность перестаёт находить объект, даже если слот занят заново
+struct EntityHandle {
+    uint32_t index = 0;
+    uint32_t generation = 0; // 0 никогда не выдаётся, поэтому handle по умолчанию пустой
+
+    bool operator==(const EntityHandle& other) const {
+        return index == other.index && generation == other.generation;
+    }
+
+    bool operator!=(const EntityHandle& other) const {
+        return !(*this == other);
+    }
+
+    // Упаковка в одно число для сохранения ссылок между сущностями
+    uint64_t toBits() const {
+        return (static_cast<uint64_t>(generation) << 32) | index;
+    }
+
+    static EntityHandle fromBits(uint64_t bits) {
+        EntityHandle handle;
+        handle.index = static_cast<uint32_t>(bits);
+        handle.generation = static_cast<uint32_t>(bits >> 32);
+        return handle;
+    }
+};
+
+// Slot map: вставка, удаление и поиск по EntityHandle за O(1),
+// живые значения лежат в плотном массиве без дыр
+template <typename V>
+class SlotMap {
+    struct Slot {
+        uint32_t dense;      // Позиция значения в values или следующий свободный слот
+        uint32_t generation; // У свободного слота - поколение, которое получит следующая вставка
+        bool occupied;
+    };
+
+    static const uint32_t npos = UINT32_MAX;
+
+    std::pmr::vector<V> values;
+    std::pmr::vector<uint32_t> owners; // Слот, которому принадлежит values[i]
+    std::pmr::vector<Slot> slots;
+    uint32_t freeHead = npos;
+
+public:
+    explicit SlotMap(std::pmr::memory_resource* memory = std::pmr::get_default_resource())
+        : values(memory), owners(memory), slots(memory) {
+    }
+
+    EntityHandle insert(V value) {
+        // Место под новый элемент готовится заранее, чтобы push_back ниже не бросал исключений.
+        // Ёмкость растёт вдвое: reserve(size() + 1) перевыделял бы массивы на каждой вставке
+        if (values.size() == values.capacity()) {
+            values.reserve(std::max<size_t>(8, 2 * values.size()));
+        }
+        if (owners.size() == owners.capacity()) {
+            owners.reserve(std::max<size_t>(8, 2 * owners.size()));
+        }
+
+        uint32_t index;
+        if (freeHead != npos) {
+            index = freeHead;
+            freeHead = slots[index].dense;
+        }
+        else {
+            if (slots.size() == npos) {
+                throw std::length_error("SlotMap is full");
+            }
+            index = static_cast<uint32_t>(slots.size());
+            slots.push_back({ 0, 1, false });
+        }
+
+        slots[index].dense = static_cast<uint32_t>(values.size());
+        slots[index].occupied = true;
+        values.push_back(std::move(value));
+        owners.push_back(index);
+
+        EntityHandle handle;
+        handle.index = index;
+        handle.generation = slots[index].generation;
+        return handle;
+    }
+
+    V* get(EntityHandle handle) {
+        if (!contains(handle)) {
+            return nullptr;
+        }
+        return &values[slots[handle.index].dense];
+    }
+
+    const V* get(EntityHandle handle) const {
+        if (!contains(handle)) {
+            return nullptr;
+        }
+        return &values[slots[handle.index].dense];
+    }
+
+    bool contains(EntityHandle handle) const {
+        // Свободный слот уже носит поколение следующей вставки, поэтому одного сравнения поколений
+        // мало: handle, собранный через fromBits, совпал бы с ним
+        return handle.index < slots.size() && slots[handle.index].occupied
+            && slots[handle.index].generation == handle.generation;
+    }
+
+    // Удаление перестановкой последнего элемента на место удаляемого
+    bool remove(EntityHandle handle) {
+        if (!contains(handle)) {
+            return false;
+        }
+
+        Slot& slot = slots[handle.index];
+        uint32_t last = static_cast<uint32_t>(values.size() - 1);
+        if (slot.dense != last) {
+            values[slot.dense] = std::move(values[last]);
+            owners[slot.dense] = owners[last];
+            slots[owners[slot.dense]].dense = slot.dense;
+        }
+        values.pop_back();
+        owners.pop_back();
+
+        if (++slot.generation == 0) {
+            slot.generation = 1;
+        }
+        slot.dense = freeHead;
+        slot.occupied = false;
+        freeHead = handle.index;
+        return true;
+    }
+
+    // Handle для значения с позицией i в плотном массиве
+    EntityHandle handleAt(size_t i) const {
+        EntityHandle handle;
+        handle.index = owners[i];
+        handle.generation = slots[owners[i]].generation;
+        return handle;
+    }
+
+    void reserve(size_t count) {
+        values.reserve(count);
+        owners.reserve(count);
+        slots.reserve(count);
+    }
+
+    size_t size() const { return values.size(); }
+    bool empty() const { return values.empty(); }
+
+    typename std::pmr::vector<V>::iterator begin() { return values.begin(); }
+    typename std::pmr::vector<V>::iterator end() { return values.end(); }
+    typename std::pmr::vector<V>::const_iterator begin() const { return values.begin(); }
+    typename std::pmr::vector<V>::const_iterator end() const { return values.end(); }
+};
+
+// Шаблонный класс GameManager: владеет сущностями и выдаёт на них EntityHandle
+template <typename T>
+class GameManager {
+    SlotMap<std::unique_ptr<T>> entities;
+public:
+    // Массивы менеджера выделяются из memory, например из memstats::CountingResource для учёта памяти
+    explicit GameManager(std::pmr::memory_resource* memory = std::pmr::get_default_resource())
+        : entities(memory) {
+    }
+
+    EntityHandle addEntity(std::unique_ptr<T> entity) {
+        return entities.insert(std::move(entity));
+    }
+
+    // nullptr, если сущность уже удалена
+    T* getEntity(EntityHandle handle) const {
+        const std::unique_ptr<T>* entity = entities.get(handle);
+        return entity ? entity->get() : nullptr;
+    }
+
+    bool removeEntity(EntityHandle handle) {
+        return entities.remove(handle);
+    }
+
+    void reserve(size_t count) {
+        entities.reserve(count);
+    }
+
+    void displayAll(text::Buffer& out) const {
+        for (const auto& entity : entities) {
+            entity->writeInfo(out);
+        }
+    }
+
+    // Текст уходит в std::cout блоками по text::Buffer::blockSize, а не построчно
+    void displayAll() const {
+        text::Buffer out;
+        for (const auto& entity : entities) {
+            entity->writeInfo(out);
+            out.flushIfFull(std::cout);
+        }
+        out.flushTo(std::cout);
+    }
+
+    const SlotMap<std::unique_ptr<T>>& getEntities() const {
+        return entities;
+    }
+};
+
+// Бинарный формат сохранения (все числа little-endian):
+//   заголовок: "LB7S", версия, общее число записей, CRC32 заголовка
+//   далее блоки по saveBlockRecords записей и не больше saveBlockStrings байт имён:
+//     число записей, размер таблицы строк,
+//     таблица строк: имена блока подряд без разделителей,
+//     записи: смещение и длина имени в таблице блока, здоровье, уровень,
+//     CRC32 всего блока
+// Блоки ограничены по размеру, поэтому файл любого размера можно писать и читать
+// с постоянным расходом памяти
+const char saveMagic[4] = { 'L', 'B', '7', 'S' };
+const uint32_t saveVersion = 2;
+const size_t saveHeaderSize = 16;
+const size_t saveBlockHeaderSize = 8;
+const size_t saveRecordSize = 16;
+const size_t saveBlockRecords = 4096;
+const size_t saveBlockStrings = 1 << 20;
+
+uint32_t crc32(const unsigned char* data, size_t size) {
+    static const auto table = [] {
+        std::vector<uint32_t> t(256);
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; ++k) {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            t[i] = c;
+        }
+        return t;
+    }();
+
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < size; ++i) {
+        crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+void putU32(std::vector<unsigned char>& out, uint32_t value) {
+    for (int i = 0; i < 4; ++i) {
+        out.push_back(static_cast<unsigned char>(value >> (8 * i)));
+    }
+}
+
+uint32_t getU32(const unsigned char* in) {
+    return static_cast<uint32_t>(in[0])
+        | (static_cast<uint32_t>(in[1]) << 8)
+        | (static_cast<uint32_t>(in[2]) << 16)
+        | (static_cast<uint32_t>(in[3]) << 24);
+}
+
+void appendSaveHeader(std::vector<unsigned char>& out, size_t recordCount) {
+    if (recordCount > UINT32_MAX) {
+        throw std::runtime_error("Too many entities for save format.");
+    }
+    size_t start = out.size();
+    out.insert(out.end(), saveMagic, saveMagic + 4);
+    putU32(out, saveVersion);
+    putU32(out, static_cast<uint32_t>(recordCount));
+    putU32(out, crc32(out.data() + start, out.size() - start));
+}
+
+// Одна сущность из файла сохранения
+struct SaveRecord {
+    std::string name;
+    int health = 0;
+    int level = 0;
+};
+
+// Собирает записи в блоки формата сохранения
+class SaveBlockWriter {
+    std::vector<unsigned char> strings;
+    std::vector<unsigned char> records;
+    size_t count = 0;
+    size_t total = 0;
+
+public:
+    void add(std::string_view name, int health, int level) {
+        if (name.size() > saveBlockStrings) {
+            throw std::runtime_error("Entity name is too long for save format.");
+        }
+        putU32(records, static_cast<uint32_t>(strings.size()));
+        putU32(records, static_cast<uint32_t>(name.size()));
+        putU32(records, static_cast<uint32_t>(health));
+        putU32(records, static_cast<uint32_t>(level));
+        strings.insert(strings.end(), name.begin(), name.end());
+        ++count;
+        ++total;
+    }
+
+    // Следующая запись с таким именем не поместится в текущий блок
+    bool needsFlush(std::string_view nextName) const {
+        return count == saveBlockRecords
+            || (count > 0 && strings.size() + nextName.size() > saveBlockStrings);
+    }
+
+    // Дописывает накопленный блок в out
+    void flush(std::vector<unsigned char>& out) {
+        if (count == 0) {
+            return;
+        }
+        size_t start = out.size();
+        putU32(out, static_cast<uint32_t>(count));
+        putU32(out, static_cast<uint32_t>(strings.size()));
+        out.insert(out.end(), strings.begin(), strings.end());
+        out.insert(out.end(), records.begin(), records.end());
+        putU32(out, crc32(out.data() + start, out.size() - start));
+
+        strings.clear();
+        records.clear();
+        count = 0;
+    }
+
+    size_t written() const {
+        return total;
+    }
+};
+
+// Читает файл сохранения поблочно, в памяти держится только текущий блок
+class SaveReader {
+    std::ifstream file;
+    size_t total = 0;
+    size_t consumed = 0;
+    std::vector<unsigned char> block;
+    size_t blockCount = 0;
+    size_t blockPos = 0;
+    const unsigned char* strings = nullptr;
+    size_t stringsSize = 0;
+    const unsigned char* records = nullptr;
+
+    void readExact(unsigned char* data, size_t size) {
+        file.read(reinterpret_cast<char*>(data), size);
+        if (static_cast<size_t>(file.gcount()) != size) {
+            throw std::runtime_error("Save file is truncated.");
+        }
+    }
+
+    void readBlock() {
+        block.resize(saveBlockHeaderSize);
+        readExact(block.data(), saveBlockHeaderSize);
+        blockCount = getU32(block.data());
+        stringsSize = getU32(block.data() + 4);
+        if (blockCount == 0 || blockCount > saveBlockRecords || blockCount > total - consumed
+            || stringsSize > saveBlockStrings) {
+            throw std::runtime_error("Save block header is corrupted.");
+        }
+
+        size_t bodySize = stringsSize + blockCount * saveRecordSize + 4;
+        block.resize(saveBlockHeaderSize + bodySize);
+        readExact(block.data() + saveBlockHeaderSize, bodySize);
+        size_t crcPos = block.size() - 4;
+        if (getU32(block.data() + crcPos) != crc32(block.data(), crcPos)) {
+            throw std::runtime_error("Save block is corrupted.");
+        }
+
+        strings = block.data() + saveBlockHeaderSize;
+        records = strings + stringsSize;
+        blockPos = 0;
+    }
+
+public:
+    explicit SaveReader(const std::string& filename) : file(filename, std::ios::binary) {
+        if (!file) {
+            throw std::runtime_error("Failed to open file for reading.");
+        }
+
+        unsigned char header[saveHeaderSize];
+        file.read(reinterpret_cast<char*>(header), saveHeaderSize);
+        if (file.gcount() != static_cast<std::streamsize>(saveHeaderSize)
+            || std::memcmp(header, saveMagic, 4) != 0) {
+            throw std::runtime_error("Not a save file.");
+        }
+        if (getU32(header + 12) != crc32(header, 12)) {
+            throw std::runtime_error("Save header is corrupted.");
+        }
+        if (getU32(header + 4) != saveVersion) {
+            throw std::runtime_error("Unsupported save version.");
+        }
+        total = getU32(header + 8);
+    }
+
+    size_t recordCount() const {
+        return total;
+    }
+
+    // Заполняет record следующей записью; false, когда записи закончились
+    bool next(SaveRecord& record) {
+        if (consumed == total) {
+            if (file.peek() != std::ifstream::traits_type::eof()) {
+                throw std::runtime_error("Save file has trailing data.");
+            }
+            return false;
+        }
+        if (blockPos == blockCount) {
+            readBlock();
+        }
+
+        const unsigned char* data = records + blockPos * saveRecordSize;
+        uint32_t nameOffset = getU32(data);
+        uint32_t nameLength = getU32(data + 4);
+        if (static_cast<uint64_t>(nameOffset) + nameLength > stringsSize) {
+            throw std::runtime_error("Save record has invalid name.");
+        }
+        record.name.assign(reinterpret_cast<const char*>(strings) + nameOffset, nameLength);
+        record.health = static_cast<int>(getU32(data + 8));
+        record.level = static_cast<int>(getU32(data + 12));
+
+        ++blockPos;
+        ++consumed;
+        return true;
+    }
+};
+
+// Сохранение данных в файл
+void saveToFile(const GameManager<Entity>& manager, const std::string& filename) {
+    const auto& entities = manager.getEntities();
+
+    std::vector<unsigned char> buffer;
+    buffer.reserve(saveHeaderSize + entities.size() * (saveRecordSize + 16));
+    appendSaveHeader(buffer, entities.size());
+
+    SaveBlockWriter writer;
+    for (const auto& entity : entities) {
+        std::string_view name = entity->getName();
+        if (writer.needsFlush(name)) {
+            writer.flush(buffer);
+        }
+        writer.add(name, entity->getHealth(), entity->getLevel());
+    }
+    writer.flush(buffer);
+
+    std::ofstream file(filename, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error("Failed to open file for writing.");
+    }
+    file.write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+    if (!file) {
+        throw std::runtime_error("Failed to write save file.");
+    }
+}
+
+// Потоковое сохранение: next() возвращает очередную сущность или nullptr в конце.
+// Сущности пишутся блоками по мере поступления, число записей дописывается в заголовок в конце
+template <typename Generator>
+void saveStreaming(const std::string& filename, Generator next) {
+    std::ofstream file(filename, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error("Failed to open file for writing.");
+    }
+
+    std::vector<unsigned char> buffer;
+    appendSaveHeader(buffer, 0);
+    file.write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+    buffer.clear();
+
+    SaveBlockWriter writer;
+    while (const Entity* entity = next()) {
+        std::string_view name = entity->getName();
+        if (writer.needsFlush(name)) {
+            writer.flush(buffer);
+            file.write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+            buffer.clear();
+        }
+        writer.add(name, entity->getHealth(), entity->getLevel());
+    }
+    writer.flush(buffer);
+    file.write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+    buffer.clear();
+
+    appendSaveHeader(buffer, writer.written());
+    file.seekp(0);
+    file.write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+    if (!file) {
+        throw std::runtime_error("Failed to write save file.");
+    }
+}
+
+// Загрузка данных из файла
+void loadFromFile(GameManager<Entity>& manager, const std::string& filename) {
+    SaveReader reader(filename);
+    manager.reserve(manager.getEntities().size() + reader.recordCount());
+
+    SaveRecord record;
+    while (reader.next(record)) {
+        manager.addEntity(std::make_unique<Player>(record.name, record.health, record.level));
+    }
+}
+
+// Сущность из сохранения для обхода без загрузки: имя берётся из записи и не добавляется
+// в таблицу символов, иначе каждое новое имя из файла оставалось бы в памяти до конца программы
+class SavedEntity : public Entity {
+    const SaveRecord& record;
+public:
+    explicit SavedEntity(const SaveRecord& record) : record(record) {}
+
+    std::string_view getName() const override {
+        return record.name;
+    }
+
+    // Символ находится, только если имя уже есть в таблице; иначе пустой символ,
+    // который не равен символу ни одного непустого имени
+    symbols::Symbol getNameSymbol() const override {
+        symbols::Symbol symbol;
+        symbols::find(record.name, symbol);
+        return symbol;
+    }
+
+    int getHealth() const override {
+        return record.health;
+    }
+
+    int getLevel() const override {
+        return record.level;
+    }
+
+    void writeInfo(text::Buffer& out) const override {
+        out << "Player: " << record.name << ", Health: " << record.health << ", Level: " << record.level << '\n';
+    }
+};
+
+// Обход сохранения без загрузки в GameManager: память не зависит от размера файла.
+// Сущность, переданная в callback, живёт только до его возврата
+template <typename Callback>
+void forEachEntityInSave(const std::string& filename, Callback callback) {
+    SaveReader reader(filename);
+    SaveRecord record;
+    while (reader.next(record)) {
+        const SavedEntity entity(record);
+        callback(static_cast<const Entity&>(entity));
+    }
+}
+
+// Разбор части старого текстового формата: по строке "имя здоровье уровень" на сущность
+std::vector<SaveRecord> parseTextChunk(const char* p, const char* end) {
+    std::vector<SaveRecord> records;
+    while (p != end) {
+        const char* lineEnd = std::find(p, end, '\n');
+        p = mapped::skipSpaces(p, lineEnd);
+        if (p != lineEnd) {
+            SaveRecord record;
+            const char* nameEnd = mapped::skipToken(p, lineEnd);
+            record.name.assign(p, nameEnd);
+
+            auto health = std::from_chars(mapped::skipSpaces(nameEnd, lineEnd), lineEnd, record.health);
+            auto level = std::from_chars(mapped::skipSpaces(health.ptr, lineEnd), lineEnd, record.level);
+            if (health.ec != std::errc() || level.ec != std::errc() || mapped::skipSpaces(level.ptr, lineEnd) != lineEnd) {
+                throw std::runtime_error("Invalid line in text save: " + std::string(p, lineEnd));
+            }
+            records.push_back(std::move(record));
+        }
+        p = (lineEnd == end) ? end : lineEnd + 1;
+    }
+    return records;
+}
+
+// Загрузка старого текстового формата "имя здоровье уровень".
+// Файл отображается в память и разбирается частями параллельно, порядок сущностей сохраняется
+void loadFromTextFile(GameManager<Entity>& manager, const std::string& filename) {
+    mapped::File file;
+    if (!file.open(filename)) {
+        throw std::runtime_error("Failed to open file for reading.");
+    }
+
+    std::vector<std::future<std::vector<SaveRecord>>> parts;
+    for (const auto& chunk : mapped::splitByLines(file.data(), file.size())) {
+        parts.push_back(std::async(std::launch::async, parseTextChunk, chunk.first, chunk.second));
+    }
+
+    std::vector<std::vector<SaveRecord>> results;
+    size_t total = 0;
+    for (auto& part : parts) {
+        results.push_back(part.get());
+        total += results.back().size();
+    }
+
+    manager.reserve(manager.getEntities().size() + total);
+    for (const auto& records : results) {
+        for (const auto& record : records) {
+            manager.addEntity(std::make_unique<Player>(record.name, record.health, record.level));
+        }
+    }
+}
+
+// Без main файл можно подключить к бенчмаркам (см. bench/)
+#ifndef LB_NO_MAIN
+int main() {
+    try {
+        // Память менеджеров учитывается отдельно и печатается в конце
+        memstats::CountingResource entityMemory(memstats::subsystem("lb7.entities"));
+
+        // Создание менеджера и добавление персонажей
+        GameManager<Entity> manager(&entityMemory);
+        manager.addEntity(std::make_unique<Player>("Hero", 100, 1));
+        manager.addEntity(std::make_unique<Player>("Villain", 50, 2));
+        manager.addEntity(std::make_unique<Player>("Dark Knight", 120, 5));
+
+        // Сохранение данных в файл
+        saveToFile(manager, "game_save.dat");
+
+        // Handle из сохранения на свободный слот с поколением его следующей вставки
+        EntityHandle guest = manager.addEntity(std::make_unique<Player>("Guest", 10, 1));
+        manager.removeEntity(guest);
+        EntityHandle forged = EntityHandle::fromBits(guest.toBits() + (uint64_t(1) << 32));
+        std::cout << "Handle to a free slot rejected: " << (manager.getEntity(forged) == nullptr ? "yes" : "no") << '\n';
+
+        // Создание нового менеджера для загрузки данных
+        GameManager<Entity> loadedManager(&entityMemory);
+
+        // Загрузка данных из файла
+        loadFromFile(loadedManager, "game_save.dat");
+
+        // Отображение загруженных персонажей
+        std::cout << "Loaded Entities:\n";
+        loadedManager.displayAll();
+
+        // Потоковое сохранение сгенерированного мира и просмотр без загрузки
+        int generated = 0;
+        Player npc("Villager", 10, 1);
+        saveStreaming("world_save.dat", [&]() -> const Entity* {
+            return generated++ < 10000 ? &npc : nullptr;
+        });
+
+        size_t npcCount = 0;
+        symbols::Symbol villager("Villager");
+        forEachEntityInSave("world_save.dat", [&npcCount, villager](const Entity& entity) {
+            if (entity.getNameSymbol() == villager) {
+                ++npcCount;
+            }
+        });
+        std::cout << "Streamed entities: " << npcCount << '\n';
+
+        // Импорт старого текстового сохранения: сначала файл в старом формате "имя здоровье уровень"
+        {
+            std::ofstream legacy("legacy_save.txt");
+            legacy << "Hero 100 1\nVillain 50 2\n";
+            if (!legacy) {
+                throw std::runtime_error("Failed to write legacy save file.");
+            }
+        }
+        GameManager<Entity> legacyManager(&entityMemory);
+        loadFromTextFile(legacyManager, "legacy_save.txt");
+        std::cout << "Imported legacy entities:\n";
+        legacyManager.displayAll();
+
+        std::cout << "\nMemory usage:\n";
+        memstats::report(std::cout);
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
+#endif // LB_NO_MAIN
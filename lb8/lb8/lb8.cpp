@@ -1,97 +1,536 @@
-﻿#include <iostream>
-#include <string>
-
-class Person {
-private:
-    std::string name;
-    int age;
-    std::string email;
-    std::string adress;
-
-public:
-    // Геттеры
-    std::string getName() const {
-        return name;
-    }
-
-    std::string getAdress() const {
-        return adress;
-    }
-
-    int getAge() const {
-        return age;
-    }
-
-    std::string getEmail() const {
-        return email;
-    }
-
-    // Сеттеры
-    void setName(const std::string& newName) {
-        if (!newName.empty()) {
-            name = newName;
-        }
-        else {
-            std::cerr << "Error: Name cannot be empty!" << std::endl;
-        }
-    }
-
-    void setAge(int newAge) {
-        if (newAge >= 0 && newAge <= 120) {
-            age = newAge;
-        }
-        else {
-            std::cerr << "Error: Age must be between 0 and 120!" << std::endl;
-        }
-    }
-
-    void setEmail(const std::string& newEmail) {
-        if (newEmail.find('@') != std::string::npos) {
-            email = newEmail;
-        }
-        else {
-            std::cerr << "Error: Invalid email format!" << std::endl;
-        }
-    }
-
-    void setAdress(const std::string& newAdress) {
-        if (!(newAdress.empty())) {
-            adress = newAdress;
-        }
-        else {
-            std::cerr << "Error: Adress can't be empty!" << std::endl;
-        }
-    }
-
-    // Метод для вывода информации о человеке
-    void displayInfo() const {
-        std::cout << "Name: " << name << ", Age: " << age << ", Email: " << email << ", Adress" << adress << std::endl;
-    }
-};
-
-int main() {
-    Person person;
-
-    // Устанавливаем значения с помощью сеттеров
-    person.setName("John Doe");
-    person.setAge(25);
-    person.setEmail("john.doe@example.com");
-    person.setAdress("Rostov-on-Don");
-
-    // Выводим информацию с помощью геттеров
-    std::cout << "Name: " << person.getName() << std::endl;
-    std::cout << "Age: " << person.getAge() << std::endl;
-    std::cout << "Email: " << person.getEmail() << std::endl;
-    std::cout << "Adress: " << person.getAdress() << std::endl;
-
-    // Пытаемся установить некорректные значения
-    person.setName(""); // Ошибка: имя не может быть пустым
-    person.setAge(150); // Ошибка: возраст должен быть от 0 до 120
-    person.setEmail("invalid-email"); // Ошибка: некорректный email
-    person.setAdress("");
-
-    // Выводим информацию о человеке
-    person.displayInfo();
-
-    return 0;
-}
+﻿#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <deque>
+#include <unordered_map>
+#include <set>
+#include <memory>
+#include <utility>
+#include <sstream>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define LB8_HAS_SSE2 1
+#endif
+
+class Person;
+
+// Получает уведомления об изменениях, прошедших проверку в сеттерах Person
+class PersonObserver {
+public:
+    virtual bool isEmailAvailable(const Person& person, const std::string& email) const = 0;
+    virtual void onAgeChanged(Person& person, int oldAge) = 0;
+    virtual void onEmailChanged(Person& person, const std::string& oldEmail) = 0;
+    virtual void onAdressChanged(Person& person, const std::string& oldAdress) = 0;
+    virtual ~PersonObserver() = default;
+};
+
+class Person {
+private:
+    std::string name;
+    int age = 0;
+    std::string email;
+    std::string adress;
+    PersonObserver* observer = nullptr;
+
+    friend class PersonDirectory;
+
+public:
+    Person() = default;
+
+    // Копия не входит в справочник, где хранится оригинал
+    Person(const Person& other)
+        : name(other.name), age(other.age), email(other.email), adress(other.adress) {
+    }
+
+    Person& operator=(const Person&) = delete;
+
+    // Геттеры
+    std::string getName() const {
+        return name;
+    }
+
+    std::string getAdress() const {
+        return adress;
+    }
+
+    int getAge() const {
+        return age;
+    }
+
+    std::string getEmail() const {
+        return email;
+    }
+
+    // Сеттеры
+    void setName(const std::string& newName) {
+        if (!newName.empty()) {
+            name = newName;
+        }
+        else {
+            std::cerr << "Error: Name cannot be empty!" << std::endl;
+        }
+    }
+
+    void setAge(int newAge) {
+        if (newAge >= 0 && newAge <= 120) {
+            int oldAge = age;
+            age = newAge;
+            if (observer) {
+                observer->onAgeChanged(*this, oldAge);
+            }
+        }
+        else {
+            std::cerr << "Error: Age must be between 0 and 120!" << std::endl;
+        }
+    }
+
+    void setEmail(const std::string& newEmail) {
+        if (newEmail.find('@') == std::string::npos) {
+            std::cerr << "Error: Invalid email format!" << std::endl;
+        }
+        else if (observer && !observer->isEmailAvailable(*this, newEmail)) {
+            std::cerr << "Error: Email is already in use!" << std::endl;
+        }
+        else {
+            std::string oldEmail = std::move(email);
+            email = newEmail;
+            if (observer) {
+                observer->onEmailChanged(*this, oldEmail);
+            }
+        }
+    }
+
+    void setAdress(const std::string& newAdress) {
+        if (!(newAdress.empty())) {
+            std::string oldAdress = std::move(adress);
+            adress = newAdress;
+            if (observer) {
+                observer->onAdressChanged(*this, oldAdress);
+            }
+        }
+        else {
+            std::cerr << "Error: Adress can't be empty!" << std::endl;
+        }
+    }
+
+    // Метод для вывода информации о человеке
+    void displayInfo() const {
+        std::cout << "Name: " << name << ", Age: " << age << ", Email: " << email << ", Adress" << adress << std::endl;
+    }
+};
+
+// Справочник людей с индексами: хэш по email, упорядоченный индекс по возрасту
+// и число людей по каждому адресу. Индексы обновляются сеттерами Person,
+// поэтому изменение через setAge или setEmail сразу видно в запросах
+class PersonDirectory : public PersonObserver {
+private:
+    std::vector<std::unique_ptr<Person>> people;
+    std::unordered_map<std::string, Person*> byEmail;
+    std::set<std::pair<int, Person*>> byAge;
+    std::unordered_map<std::string, size_t> adressCounts;
+
+public:
+    PersonDirectory() = default;
+    PersonDirectory(const PersonDirectory&) = delete;
+    PersonDirectory& operator=(const PersonDirectory&) = delete;
+
+    // Добавляет человека; при неверных данных сеттеры сообщают об ошибке и возвращается nullptr
+    Person* add(const std::string& name, int age, const std::string& email, const std::string& adress) {
+        if (byEmail.count(email) != 0) {
+            std::cerr << "Error: Email is already in use!" << std::endl;
+            return nullptr;
+        }
+
+        auto person = std::make_unique<Person>();
+        person->setName(name);
+        person->setAge(age);
+        person->setEmail(email);
+        person->setAdress(adress);
+        if (person->name != name || person->age != age || person->email != email || person->adress != adress) {
+            return nullptr;
+        }
+
+        Person* raw = person.get();
+        people.push_back(std::move(person));
+        byEmail.emplace(raw->email, raw);
+        byAge.emplace(raw->age, raw);
+        ++adressCounts[raw->adress];
+        raw->observer = this;
+        return raw;
+    }
+
+    Person* findByEmail(const std::string& email) const {
+        auto it = byEmail.find(email);
+        return it != byEmail.end() ? it->second : nullptr;
+    }
+
+    // Люди с возрастом от minAge до maxAge включительно, по возрастанию возраста
+    std::vector<Person*> findByAgeRange(int minAge, int maxAge) const {
+        std::vector<Person*> result;
+        for (auto it = byAge.lower_bound({ minAge, nullptr }); it != byAge.end() && it->first <= maxAge; ++it) {
+            result.push_back(it->second);
+        }
+        return result;
+    }
+
+    // Число людей по каждому адресу
+    const std::unordered_map<std::string, size_t>& countByAdress() const {
+        return adressCounts;
+    }
+
+    size_t size() const {
+        return people.size();
+    }
+
+    bool isEmailAvailable(const Person& person, const std::string& email) const override {
+        auto it = byEmail.find(email);
+        return it == byEmail.end() || it->second == &person;
+    }
+
+    void onAgeChanged(Person& person, int oldAge) override {
+        byAge.erase({ oldAge, &person });
+        byAge.emplace(person.age, &person);
+    }
+
+    void onEmailChanged(Person& person, const std::string& oldEmail) override {
+        byEmail.erase(oldEmail);
+        byEmail.emplace(person.email, &person);
+    }
+
+    void onAdressChanged(Person& person, const std::string& oldAdress) override {
+        auto it = adressCounts.find(oldAdress);
+        if (--it->second == 0) {
+            adressCounts.erase(it);
+        }
+        ++adressCounts[person.adress];
+    }
+};
+
+// Столбец строк: все значения подряд в одном буфере и смещения начала каждого
+class StringColumn {
+private:
+    std::string data;
+    std::vector<size_t> offsets{ 0 };
+
+public:
+    void push(std::string_view value) {
+        data.append(value.data(), value.size());
+        offsets.push_back(data.size());
+    }
+
+    size_t size() const { return offsets.size() - 1; }
+    size_t length(size_t row) const { return offsets[row + 1] - offsets[row]; }
+    std::string_view get(size_t row) const { return std::string_view(data).substr(offsets[row], length(row)); }
+    const std::string& buffer() const { return data; }
+    const std::vector<size_t>& bounds() const { return offsets; }
+
+    void clear() {
+        data.clear();
+        offsets.assign(1, 0);
+    }
+
+    size_t memoryUsage() const {
+        return data.capacity() + offsets.capacity() * sizeof(size_t);
+    }
+};
+
+// Отмечает строки столбца, в которых встречается символ c.
+// Буфер столбца просматривается целиком, по 16 байт за одно SSE2-сравнение
+std::vector<uint8_t> rowsContaining(const StringColumn& column, char c) {
+    std::vector<uint8_t> found(column.size(), 0);
+    const std::string& data = column.buffer();
+    const std::vector<size_t>& offsets = column.bounds();
+    size_t row = 0;
+
+    auto mark = [&](size_t pos) {
+        while (offsets[row + 1] <= pos) {
+            ++row;
+        }
+        found[row] = 1;
+    };
+
+    size_t pos = 0;
+#ifdef LB8_HAS_SSE2
+    const __m128i needle = _mm_set1_epi8(c);
+    for (; pos + 16 <= data.size(); pos += 16) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data.data() + pos));
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, needle)));
+        while (mask != 0) {
+            unsigned bit = 0;
+            while (!(mask & (1u << bit))) {
+                ++bit;
+            }
+            mark(pos + bit);
+            mask &= mask - 1;
+        }
+    }
+#endif
+    for (; pos < data.size(); ++pos) {
+        if (data[pos] == c) {
+            mark(pos);
+        }
+    }
+    return found;
+}
+
+// Поле записи о человеке
+enum class PersonField {
+    Name,
+    Age,
+    Email,
+    Adress
+};
+
+// Ошибка в одной строке импорта
+struct ValidationError {
+    size_t row;
+    PersonField field;
+    std::string message;
+};
+
+// Итог импорта: сколько строк принято и что не так с остальными
+struct ImportReport {
+    size_t accepted = 0;
+    std::vector<ValidationError> errors;
+};
+
+// Таблица проверенных записей, хранится по столбцам.
+// Имена и email лежат подряд в общих буферах, адреса (обычно это несколько городов)
+// хранятся один раз в словаре, а в строке таблицы остаётся только номер адреса.
+// Геттеры возвращают std::string_view без копирования; он действителен до следующего addRow
+class PersonTable {
+private:
+    StringColumn names;
+    StringColumn emails;
+    std::vector<uint8_t> ages;
+    std::vector<uint32_t> adressCodes;
+    // Ключи словаря указывают на строки adressValues: deque не перемещает элементы при добавлении,
+    // поэтому поиск адреса идёт по std::string_view без временной строки
+    std::deque<std::string> adressValues;
+    std::unordered_map<std::string_view, uint32_t> adressDictionary;
+
+    uint32_t encodeAdress(std::string_view adress) {
+        auto it = adressDictionary.find(adress);
+        if (it != adressDictionary.end()) {
+            return it->second;
+        }
+        uint32_t code = static_cast<uint32_t>(adressValues.size());
+        adressValues.emplace_back(adress);
+        adressDictionary.emplace(adressValues.back(), code);
+        return code;
+    }
+
+public:
+    // Возраст уже проверен: от 0 до 120, поэтому хватает одного байта
+    void addRow(std::string_view name, int age, std::string_view email, std::string_view adress) {
+        adressCodes.push_back(encodeAdress(adress));
+        names.push(name);
+        emails.push(email);
+        ages.push_back(static_cast<uint8_t>(age));
+    }
+
+    size_t size() const { return ages.size(); }
+    std::string_view getName(size_t row) const { return names.get(row); }
+    int getAge(size_t row) const { return ages[row]; }
+    std::string_view getEmail(size_t row) const { return emails.get(row); }
+    std::string_view getAdress(size_t row) const { return adressValues[adressCodes[row]]; }
+
+    // Сколько памяти занимает таблица, в байтах
+    size_t memoryUsage() const {
+        size_t bytes = sizeof(*this) + names.memoryUsage() + emails.memoryUsage()
+            + ages.capacity() + adressCodes.capacity() * sizeof(uint32_t)
+            + adressValues.size() * sizeof(std::string);
+        for (const auto& adress : adressValues) {
+            bytes += adress.capacity() + 1;
+        }
+        // Узлы словаря: ключ, значение и указатель на следующий узел, плюс корзины
+        bytes += adressDictionary.size() * (sizeof(std::string_view) + sizeof(uint32_t) + sizeof(void*))
+            + adressDictionary.bucket_count() * sizeof(void*);
+        return bytes;
+    }
+};
+
+// Пакетный импорт записей о людях. Строки копятся по столбцам, затем каждый
+// столбец проверяется целиком теми же правилами, что и сеттеры Person
+class PersonBatch {
+private:
+    StringColumn names;
+    std::vector<int32_t> ages;
+    StringColumn emails;
+    StringColumn adresses;
+    std::vector<uint8_t> ageParsed; // 0, если возраст в CSV не удалось прочитать
+
+public:
+    void addRow(const std::string& name, int age, const std::string& email, const std::string& adress) {
+        names.push(name);
+        ages.push_back(age);
+        emails.push(email);
+        adresses.push(adress);
+        ageParsed.push_back(1);
+    }
+
+    // Строки CSV вида "имя,возраст,email,адрес"
+    void loadCsv(std::istream& in) {
+        std::string line;
+        while (std::getline(in, line)) {
+            if (!line.empty() && line.back() == '\r') {
+                line.pop_back();
+            }
+            if (line.empty()) {
+                continue;
+            }
+
+            std::string fields[4];
+            std::istringstream row(line);
+            for (auto& field : fields) {
+                std::getline(row, field, ',');
+            }
+
+            int age = 0;
+            bool parsed = false;
+            try {
+                size_t used = 0;
+                age = std::stoi(fields[1], &used);
+                parsed = used == fields[1].size();
+            }
+            catch (const std::exception&) {
+            }
+            addRow(fields[0], age, fields[2], fields[3]);
+            ageParsed.back() = parsed ? 1 : 0;
+        }
+    }
+
+    size_t size() const {
+        return names.size();
+    }
+
+    // Проверяет все накопленные строки, корректные переносит в table и очищает пакет
+    ImportReport validate(PersonTable& table) {
+        size_t count = size();
+
+        std::vector<uint8_t> ageOk(count);
+        for (size_t i = 0; i < count; ++i) {
+            ageOk[i] = static_cast<uint8_t>(static_cast<uint32_t>(ages[i]) <= 120u) & ageParsed[i];
+        }
+        std::vector<uint8_t> emailOk = rowsContaining(emails, '@');
+
+        ImportReport report;
+        for (size_t i = 0; i < count; ++i) {
+            bool nameOk = names.length(i) != 0;
+            bool adressOk = adresses.length(i) != 0;
+            if (nameOk && ageOk[i] && emailOk[i] && adressOk) {
+                table.addRow(names.get(i), ages[i], emails.get(i), adresses.get(i));
+                ++report.accepted;
+                continue;
+            }
+            if (!nameOk) report.errors.push_back({ i, PersonField::Name, "Name cannot be empty" });
+            if (!ageOk[i]) report.errors.push_back({ i, PersonField::Age, "Age must be between 0 and 120" });
+            if (!emailOk[i]) report.errors.push_back({ i, PersonField::Email, "Invalid email format" });
+            if (!adressOk) report.errors.push_back({ i, PersonField::Adress, "Adress can't be empty" });
+        }
+
+        names.clear();
+        ages.clear();
+        emails.clear();
+        adresses.clear();
+        ageParsed.clear();
+        return report;
+    }
+};
+
+int main() {
+    Person person;
+
+    // Устанавливаем значения с помощью сеттеров
+    person.setName("John Doe");
+    person.setAge(25);
+    person.setEmail("john.doe@example.com");
+    person.setAdress("Rostov-on-Don");
+
+    // Выводим информацию с помощью геттеров
+    std::cout << "Name: " << person.getName() << std::endl;
+    std::cout << "Age: " << person.getAge() << std::endl;
+    std::cout << "Email: " << person.getEmail() << std::endl;
+    std::cout << "Adress: " << person.getAdress() << std::endl;
+
+    // Пытаемся установить некорректные значения
+    person.setName(""); // Ошибка: имя не может быть пустым
+    person.setAge(150); // Ошибка: возраст должен быть от 0 до 120
+    person.setEmail("invalid-email"); // Ошибка: некорректный email
+    person.setAdress("");
+
+    // Выводим информацию о человеке
+    person.displayInfo();
+
+    // Сравнение памяти: std::vector<Person> и PersonTable на миллионе записей
+    {
+        const size_t count = 1000000;
+        const char* cities[] = { "Moscow", "Saint Petersburg", "Rostov-on-Don", "Kazan", "Novosibirsk" };
+        const size_t smallString = std::string().capacity();
+        auto heapBytes = [smallString](const std::string& s) {
+            return s.capacity() > smallString ? s.capacity() + 1 : 0;
+        };
+
+        std::vector<Person> people(count);
+        PersonTable table;
+        size_t vectorBytes = people.capacity() * sizeof(Person);
+        for (size_t i = 0; i < count; ++i) {
+            std::string id = std::to_string(i);
+            people[i].setName("Person " + id);
+            people[i].setAge(static_cast<int>(i % 100));
+            people[i].setEmail("person" + id + "@example.com");
+            people[i].setAdress(cities[i % 5]);
+            table.addRow(people[i].getName(), people[i].getAge(), people[i].getEmail(), people[i].getAdress());
+
+            vectorBytes += heapBytes(people[i].getName()) + heapBytes(people[i].getEmail())
+                + heapBytes(people[i].getAdress());
+        }
+
+        std::cout << "\nMemory for " << count << " people:" << std::endl;
+        std::cout << "std::vector<Person>: " << vectorBytes / 1024 << " KiB" << std::endl;
+        std::cout << "PersonTable:         " << table.memoryUsage() / 1024 << " KiB" << std::endl;
+    }
+
+    // Запросы к справочнику
+    PersonDirectory directory;
+    directory.add("Anna", 19, "anna@example.com", "Rostov-on-Don");
+    directory.add("Boris", 34, "boris@example.com", "Moscow");
+    Person* clara = directory.add("Clara", 23, "clara@example.com", "Rostov-on-Don");
+    directory.add("Denis", 41, "denis@example.com", "Kazan");
+    clara->setAge(27); // Индекс по возрасту обновится сам
+
+    std::cout << "\nPeople aged 18-25:" << std::endl;
+    for (const Person* p : directory.findByAgeRange(18, 25)) {
+        p->displayInfo();
+    }
+    if (const Person* p = directory.findByEmail("boris@example.com")) {
+        std::cout << "Found by email: " << p->getName() << std::endl;
+    }
+    std::cout << "People per adress:" << std::endl;
+    for (const auto& entry : directory.countByAdress()) {
+        std::cout << entry.first << ": " << entry.second << std::endl;
+    }
+
+    // Пакетный импорт из CSV
+    std::istringstream csv(
+        "Alice,30,alice@example.com,Moscow\n"
+        "Bob,150,bob@example.com,Rostov-on-Don\n"
+        ",22,anonymous-at-example.com,Kazan\n"
+        "Carol,abc,carol@example.com,\n"
+        "Dave,45,dave@example.com,Rostov-on-Don\n");
+    PersonBatch batch;
+    batch.loadCsv(csv);
+
+    PersonTable table;
+    ImportReport report = batch.validate(table);
+    std::cout << "\nImported " << report.accepted << " people, rejected rows:" << std::endl;
+    for (const auto& error : report.errors) {
+        std::cout << "Row " << error.row + 1 << ": " << error.message << std::endl;
+    }
+
+    return 0;
+}
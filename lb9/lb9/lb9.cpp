@@ -1,444 +1,1348 @@
-﻿#include <iostream>
-#include <string>
-#include <vector>
-#include <fstream>
-#include <stdexcept>
-#include <sstream>
-#include <algorithm>
-#include <memory>
-#include <ctime>
-#include <iomanip>
-#include <chrono>
-
-// Шаблонный класс Logger для записи логов в файл
-template<typename T>
-class Logger {
-public:
-    Logger(const std::string& filename) : logFile(filename, std::ios::app) {
-        if (!logFile.is_open()) {
-            throw std::runtime_error("Failed to open log file");
-        }
-    }
-
-    void log(const T& message) {
-        auto now = std::chrono::system_clock::now();
-        auto now_time = std::chrono::system_clock::to_time_t(now);
-
-        // Безопасная версия с localtime_s
-        std::tm tm;
-        localtime_s(&tm, &now_time);
-
-        logFile << std::put_time(&tm, "%Y-%m-%d %H:%M:%S") << " - " << message << std::endl;
-    }
-
-    ~Logger() {
-        if (logFile.is_open()) {
-            logFile.close();
-        }
-    }
-
-private:
-    std::ofstream logFile;
-};
-
-// Базовый класс для всех существ
-class Entity {
-protected:
-    std::string name;
-    int maxHealth;
-    int health;
-    int attack;
-    int defense;
-
-public:
-    Entity(const std::string& n, int h, int a, int d)
-        : name(n), maxHealth(h), health(h), attack(a), defense(d) {
-    }
-
-    virtual void attackEnemy(Entity& enemy, Logger<std::string>& logger) {
-        try {
-            int damage = attack - enemy.getDefense();
-            if (damage > 0) {
-                enemy.takeDamage(damage);
-                std::string msg = name + " attacks " + enemy.getName() + " for " + std::to_string(damage) + " damage!";
-                logger.log(msg);
-                std::cout << msg << std::endl;
-            }
-            else {
-                std::string msg = name + " attacks " + enemy.getName() + ", but it has no effect!";
-                logger.log(msg);
-                std::cout << msg << std::endl;
-            }
-        }
-        catch (const std::runtime_error& e) {
-            logger.log(e.what());
-            std::cout << e.what() << std::endl;
-        }
-    }
-
-    virtual void takeDamage(int damage) {
-        if (health - damage <= 0) {
-            health = 0;
-            throw std::runtime_error(name + " has been defeated!");
-        }
-        health -= damage;
-    }
-
-    virtual void heal(int amount) {
-        if (health + amount > maxHealth) {
-            health = maxHealth;
-        }
-        else {
-            health += amount;
-        }
-    }
-
-    std::string getName() const { return name; }
-    int getHealth() const { return health; }
-    int getAttack() const { return attack; }
-    int getDefense() const { return defense; }
-    int getMaxHealth() const { return maxHealth; }
-
-    virtual void displayInfo() const {
-        std::cout << "Name: " << name << ", HP: " << health
-            << ", Attack: " << attack << ", Defense: " << defense << std::endl;
-    }
-
-    virtual ~Entity() = default;
-};
-
-// Класс предмета
-class Item {
-public:
-    virtual ~Item() = default;
-    virtual void use(Entity& target) = 0;
-    virtual std::string getName() const = 0;
-    virtual std::string getType() const = 0;
-};
-
-// Класс оружия
-class Weapon : public Item {
-public:
-    Weapon(const std::string& name, int damage) : name(name), damage(damage) {}
-
-    void use(Entity& target) override {
-        target.takeDamage(damage);
-    }
-
-    std::string getName() const override { return name; }
-    std::string getType() const override { return "Weapon"; }
-    int getDamage() const { return damage; }
-
-private:
-    std::string name;
-    int damage;
-};
-
-// Класс зелья
-class Potion : public Item {
-public:
-    Potion(const std::string& name, int healAmount) : name(name), healAmount(healAmount) {}
-
-    void use(Entity& target) override {
-        target.heal(healAmount);
-    }
-
-    std::string getName() const override { return name; }
-    std::string getType() const override { return "Potion"; }
-
-private:
-    std::string name;
-    int healAmount;
-};
-
-// Класс инвентаря
-class Inventory {
-private:
-    std::vector<std::unique_ptr<Item>> items;
-
-public:
-    void addItem(std::unique_ptr<Item> item) {
-        items.push_back(std::move(item));
-    }
-
-    void dropItem(const std::string& itemName) {
-        auto it = std::find_if(items.begin(), items.end(),
-            [&itemName](const auto& item) { return item->getName() == itemName; });
-
-        if (it != items.end()) {
-            items.erase(it);
-            std::cout << "Dropped: " << itemName << std::endl;
-        }
-        else {
-            throw std::runtime_error("Item not found: " + itemName);
-        }
-    }
-
-    void useItem(const std::string& itemName, Entity& target) {
-        auto it = std::find_if(items.begin(), items.end(),
-            [&itemName](const auto& item) { return item->getName() == itemName; });
-
-        if (it != items.end()) {
-            (*it)->use(target);
-            items.erase(it);
-        }
-        else {
-            throw std::runtime_error("Item not found: " + itemName);
-        }
-    }
-
-    void showItems() const {
-        std::cout << "Inventory:\n";
-        for (const auto& item : items) {
-            std::cout << "- " << item->getName() << " (" << item->getType() << ")\n";
-        }
-    }
-
-    bool hasItem(const std::string& itemName) const {
-        return std::any_of(items.begin(), items.end(),
-            [&itemName](const auto& item) { return item->getName() == itemName; });
-    }
-};
-
-// Класс персонажа
-class Character : public Entity {
-private:
-    int level;
-    int experience;
-    Inventory inventory;
-
-public:
-    Character(const std::string& n, int h, int a, int d)
-        : Entity(n, h, a, d), level(1), experience(0) {
-    }
-
-    void heal(int amount, Logger<std::string>& logger) {
-        int oldHealth = health;
-        Entity::heal(amount);
-        int healed = health - oldHealth;
-        logger.log(name + " heals for " + std::to_string(healed) + " HP!");
-    }
-
-    void gainExperience(int exp, Logger<std::string>& logger) {
-        experience += exp;
-        if (experience >= 100) {
-            level++;
-            experience -= 100;
-            attack += 2;
-            defense += 1;
-            maxHealth += 10;
-            health = maxHealth;
-            logger.log(name + " leveled up to level " + std::to_string(level) + "!");
-        }
-    }
-
-    void addItem(std::unique_ptr<Item> item) {
-        inventory.addItem(std::move(item));
-    }
-
-    void dropItem(const std::string& item) {
-        inventory.dropItem(item);
-    }
-
-    void useItem(const std::string& item) {
-        inventory.useItem(item, *this);
-    }
-
-    void showInventory() const {
-        inventory.showItems();
-    }
-
-    int getLevel() const { return level; }
-    int getExperience() const { return experience; }
-};
-
-// Класс монстра
-class Monster : public Entity {
-public:
-    Monster(const std::string& n, int h, int a, int d) : Entity(n, h, a, d) {}
-};
-
-// Производные классы монстров
-class Goblin : public Monster {
-public:
-    Goblin() : Monster("Goblin", 30, 10, 2) {}
-};
-
-class Dragon : public Monster {
-public:
-    Dragon() : Monster("Dragon", 150, 40, 10) {}
-};
-
-// Класс скелета с сопротивлением
-class Skeleton : public Monster {
-public:
-    Skeleton(const std::string& name, int health, int attack, int defense, bool isResistant = true)
-        : Monster(name, health, attack, defense), isResistant(isResistant) {
-    }
-
-    void takeDamage(int damage) override {
-        if (isResistant) {
-            damage /= 2;
-            std::cout << name << " resists some damage!\n";
-        }
-        Monster::takeDamage(damage);
-    }
-
-private:
-    bool isResistant;
-};
-
-// Класс игры с улучшенной системой сохранения
-class Game {
-public:
-    void saveGame(const Character& character, const std::string& filename = "savegame.txt") {
-        std::ofstream file(filename);
-        if (!file) {
-            throw std::runtime_error("Failed to open save file");
-        }
-
-        file << character.getName() << "\n"
-            << character.getHealth() << "\n"
-            << character.getMaxHealth() << "\n"
-            << character.getAttack() << "\n"
-            << character.getDefense() << "\n"
-            << character.getLevel() << "\n"
-            << character.getExperience() << "\n";
-
-        // Здесь можно добавить сохранение инвентаря
-        file.close();
-    }
-
-    Character loadGame(const std::string& filename = "savegame.txt") {
-        std::ifstream file(filename);
-        if (!file) {
-            throw std::runtime_error("Failed to open save file");
-        }
-
-        std::string name;
-        int health, maxHealth, attack, defense, level, experience;
-
-        std::getline(file, name);
-        file >> health >> maxHealth >> attack >> defense >> level >> experience;
-        file.ignore();
-
-        Character character(name, maxHealth, attack, defense);
-        character.heal(health - character.getHealth(), *logger); // Восстанавливаем здоровье
-        for (int i = 1; i < level; ++i) {
-            character.gainExperience(100, *logger); // Имитируем получение уровней
-        }
-        character.gainExperience(experience, *logger); // Добавляем оставшийся опыт
-
-        // Здесь можно добавить загрузку инвентаря
-        return character;
-    }
-
-    void setLogger(std::shared_ptr<Logger<std::string>> newLogger) {
-        logger = newLogger;
-    }
-
-private:
-    std::shared_ptr<Logger<std::string>> logger;
-};
-
-int main() {
-    try {
-        // Инициализация логгера
-        auto logger = std::make_shared<Logger<std::string>>("game_log.txt");
-        logger->log("=== Game session started ===");
-
-        // Инициализация игровых объектов
-        Game game;
-        game.setLogger(logger);
-
-        // Создание персонажа
-        Character hero("Sir Lancelot", 120, 25, 15);
-        logger->log("Player created: " + hero.getName());
-
-        // Создание монстров
-        Skeleton skeleton1("Bony", 60, 12, 8, true);
-        Skeleton skeleton2("Rusty", 55, 10, 7);
-        Dragon dragon;
-        logger->log("Enemies spawned: " + skeleton1.getName() + ", " + skeleton2.getName() + ", " + dragon.getName());
-
-        // Добавление предметов в инвентарь
-        hero.addItem(std::make_unique<Weapon>("Excalibur", 35));
-        hero.addItem(std::make_unique<Weapon>("Steel Dagger", 15));
-        hero.addItem(std::make_unique<Potion>("Health Elixir", 50));
-        hero.addItem(std::make_unique<Potion>("Mana Potion", 30));
-        logger->log("Items added to inventory");
-
-        // Демонстрация инвентаря
-        std::cout << "\n=== Initial Hero State ===\n";
-        hero.displayInfo();
-        std::cout << "Inventory:\n";
-        hero.showInventory();
-
-        // Бой со скелетом 1
-        std::cout << "\n=== Battle with " << skeleton1.getName() << " ===\n";
-        hero.attackEnemy(skeleton1, *logger);
-        skeleton1.attackEnemy(hero, *logger);
-        hero.attackEnemy(skeleton1, *logger);
-
-        // Использование зелья
-        std::cout << "\n=== Using Health Potion ===\n";
-        hero.useItem("Health Elixir");
-        hero.showInventory();
-
-        // Бой со скелетом 2
-        std::cout << "\n=== Battle with " << skeleton2.getName() << " ===\n";
-        hero.attackEnemy(skeleton2, *logger);
-        skeleton2.attackEnemy(hero, *logger);
-        hero.attackEnemy(skeleton2, *logger);
-
-        // Получение опыта
-        std::cout << "\n=== Gaining Experience ===\n";
-        hero.gainExperience(75, *logger);
-        hero.gainExperience(50, *logger); // Должен повысить уровень
-        hero.displayInfo();
-
-        // Бой с драконом
-        std::cout << "\n=== Epic Battle with " << dragon.getName() << " ===\n";
-        for (int i = 0; i < 3; ++i) {
-            hero.attackEnemy(dragon, *logger);
-            dragon.attackEnemy(hero, *logger);
-        }
-
-        // Сохранение игры
-        std::cout << "\n=== Saving Game ===\n";
-        game.saveGame(hero, "hero_save.txt");
-        logger->log("Game saved");
-
-        // Загрузка игры
-        std::cout << "\n=== Loading Game ===\n";
-        Character loadedHero = game.loadGame("hero_save.txt");
-        loadedHero.displayInfo();
-        loadedHero.showInventory();
-
-        // Демонстрация обработки исключений
-        std::cout << "\n=== Exception Handling Demo ===\n";
-        try {
-            loadedHero.useItem("Nonexistent Item");
-        }
-        catch (const std::exception& e) {
-            std::cout << "Error: " << e.what() << std::endl;
-            logger->log(std::string("Exception: ") + e.what());
-        }
-
-        // Создание нового персонажа и демонстрация инвентаря
-        std::cout << "\n=== New Character Demo ===\n";
-        Character mage("Gandalf", 80, 15, 10);
-        mage.addItem(std::make_unique<Potion>("Mega Potion", 100));
-        mage.addItem(std::make_unique<Weapon>("Magic Staff", 20));
-        mage.displayInfo();
-        mage.showInventory();
-
-        logger->log("=== Game session ended ===\n");
-    }
-    catch (const std::exception& e) {
-        std::cerr << "Fatal Error: " << e.what() << std::endl;
-        return 1;
-    }
-
-    return 0;
-}
\ No newline at end of file
+﻿#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <fstream>
+#include <stdexcept>
+#include <sstream>
+#include <algorithm>
+#include <memory>
+#include <unordered_map>
+#include <ctime>
+#include <iomanip>
+#include <chrono>
+#include <cstdint>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <shared_mutex>
+#include <condition_variable>
+#include <functional>
+#include <exception>
+
+#include "../../common/arena.h"
+#include "../../common/memory_stats.h"
+#include "../../common/symbols.h"
+#include "../../common/text_buffer.h"
+#include "../../common/trace.h"
+
+// Шаблонный класс Logger для записи логов в файл
+template<typename T>
+class Logger {
+public:
+    Logger(const std::string& filename) : logFile(filename, std::ios::app) {
+        if (!logFile.is_open()) {
+            throw std::runtime_error("Failed to open log file");
+        }
+    }
+
+    void log(const T& message) {
+        write(message);
+    }
+
+    // Строки с другим аллокатором, например std::pmr::string из арены боя, пишутся без копирования
+    template<typename Allocator>
+    void log(const std::basic_string<char, std::char_traits<char>, Allocator>& message) {
+        write(message);
+    }
+
+    ~Logger() {
+        if (logFile.is_open()) {
+            logFile.close();
+        }
+    }
+
+private:
+    template<typename M>
+    void write(const M& message) {
+        TRACE_SCOPE("Logger::log");
+        auto now = std::chrono::system_clock::now();
+        auto now_time = std::chrono::system_clock::to_time_t(now);
+
+        // Безопасная версия: localtime_s в MSVC, localtime_r в POSIX
+        std::tm tm;
+#ifdef _WIN32
+        localtime_s(&tm, &now_time);
+#else
+        localtime_r(&now_time, &tm);
+#endif
+
+        logFile << std::put_time(&tm, "%Y-%m-%d %H:%M:%S") << " - " << message << std::endl;
+    }
+
+    std::ofstream logFile;
+};
+
+// Базовый класс для всех существ
+class Entity {
+protected:
+    symbols::Symbol name; // Одинаковые имена хранятся один раз в таблице символов
+    int maxHealth;
+    int health;
+    int attack;
+    int defense;
+
+public:
+    Entity(const std::string& n, int h, int a, int d)
+        : name(n), maxHealth(h), health(h), attack(a), defense(d) {
+    }
+
+    virtual void attackEnemy(Entity& enemy, Logger<std::string>& logger) {
+        TRACE_SCOPE("Entity::attackEnemy");
+        try {
+            int damage = attack - enemy.getDefense();
+            // Сообщения временные: при активной арене боя память берётся из неё
+            std::pmr::string msg(arena::resource());
+            if (damage > 0) {
+                enemy.takeDamage(damage);
+                msg.append(name.view()).append(" attacks ").append(enemy.getName())
+                    .append(" for ").append(std::to_string(damage)).append(" damage!");
+                logger.log(msg);
+                std::cout << msg << std::endl;
+            }
+            else {
+                msg.append(name.view()).append(" attacks ").append(enemy.getName()).append(", but it has no effect!");
+                logger.log(msg);
+                std::cout << msg << std::endl;
+            }
+        }
+        catch (const std::runtime_error& e) {
+            logger.log(e.what());
+            std::cout << e.what() << std::endl;
+        }
+    }
+
+    virtual void takeDamage(int damage) {
+        if (applyDamage(damage)) {
+            std::pmr::string msg(arena::resource());
+            msg.append(name.view()).append(" has been defeated!");
+            throw std::runtime_error(msg.c_str());
+        }
+    }
+
+    // Урон после защитных свойств существа (сопротивление скелета и т.п.)
+    virtual int absorbDamage(int damage) const {
+        return damage;
+    }
+
+    // Урон без вывода и исключений для массовых боёв в World; true, если существо побеждено
+    bool applyDamage(int damage) {
+        if (health - damage <= 0) {
+            health = 0;
+            return true;
+        }
+        health -= damage;
+        return false;
+    }
+
+    virtual void heal(int amount) {
+        if (health + amount > maxHealth) {
+            health = maxHealth;
+        }
+        else {
+            health += amount;
+        }
+    }
+
+    std::string_view getName() const { return name.view(); }
+    symbols::Symbol getNameSymbol() const { return name; }
+    int getHealth() const { return health; }
+    int getAttack() const { return attack; }
+    int getDefense() const { return defense; }
+    int getMaxHealth() const { return maxHealth; }
+
+    // Описание пишется в буфер; displayInfo выводит его в std::cout одной записью
+    virtual void writeInfo(text::Buffer& out) const {
+        out << "Name: " << name.view() << ", HP: " << health
+            << ", Attack: " << attack << ", Defense: " << defense << '\n';
+    }
+
+    void displayInfo() const {
+        text::Buffer out;
+        writeInfo(out);
+        out.flushTo(std::cout);
+    }
+
+    virtual ~Entity() = default;
+};
+
+// Запись и чтение чисел и строк в бинарных сохранениях (little-endian)
+void writeInt(std::ostream& out, int32_t value) {
+    uint32_t bits = static_cast<uint32_t>(value);
+    char bytes[4];
+    for (int i = 0; i < 4; ++i) {
+        bytes[i] = static_cast<char>(bits >> (8 * i));
+    }
+    out.write(bytes, 4);
+}
+
+int32_t readInt(std::istream& in) {
+    unsigned char bytes[4];
+    if (!in.read(reinterpret_cast<char*>(bytes), 4)) {
+        throw std::runtime_error("Save file is truncated");
+    }
+    uint32_t bits = 0;
+    for (int i = 0; i < 4; ++i) {
+        bits |= static_cast<uint32_t>(bytes[i]) << (8 * i);
+    }
+    return static_cast<int32_t>(bits);
+}
+
+void writeString(std::ostream& out, std::string_view value) {
+    writeInt(out, static_cast<int32_t>(value.size()));
+    out.write(value.data(), value.size());
+}
+
+std::string readString(std::istream& in) {
+    int32_t size = readInt(in);
+    if (size < 0 || size > (1 << 20)) {
+        throw std::runtime_error("Save file is corrupted");
+    }
+    std::string value(static_cast<size_t>(size), '\0');
+    if (!in.read(&value[0], size)) {
+        throw std::runtime_error("Save file is truncated");
+    }
+    return value;
+}
+
+// Метки типов предметов в сохранении
+enum class ItemTag : int32_t {
+    Weapon = 1,
+    Potion = 2
+};
+
+// Класс предмета: общее описание, одно на все экземпляры предмета с этим именем.
+// Описания хранятся в ItemRegistry и после регистрации не меняются
+class Item {
+public:
+    virtual ~Item() = default;
+    virtual void use(Entity& target) const = 0;
+    virtual std::string_view getName() const = 0;
+    virtual symbols::Symbol getNameSymbol() const = 0;
+    virtual std::string getType() const = 0;
+    // Сила предмета: урон оружия или сила лечения зелья
+    virtual int getPower() const = 0;
+    virtual int getMaxDurability() const { return 0; }
+    virtual void saveToFile(std::ostream& out) const = 0;
+};
+
+// Класс оружия
+class Weapon : public Item {
+public:
+    Weapon(const std::string& name, int damage) : name(name), damage(damage) {}
+
+    void use(Entity& target) const override {
+        target.takeDamage(damage);
+    }
+
+    std::string_view getName() const override { return name.view(); }
+    symbols::Symbol getNameSymbol() const override { return name; }
+    std::string getType() const override { return "Weapon"; }
+    int getDamage() const { return damage; }
+    int getPower() const override { return damage; }
+    int getMaxDurability() const override { return 100; }
+
+    void saveToFile(std::ostream& out) const override {
+        writeInt(out, static_cast<int32_t>(ItemTag::Weapon));
+        writeString(out, name.view());
+        writeInt(out, damage);
+    }
+
+private:
+    symbols::Symbol name;
+    int damage;
+};
+
+// Класс зелья
+class Potion : public Item {
+public:
+    Potion(const std::string& name, int healAmount) : name(name), healAmount(healAmount) {}
+
+    void use(Entity& target) const override {
+        target.heal(healAmount);
+    }
+
+    std::string_view getName() const override { return name.view(); }
+    symbols::Symbol getNameSymbol() const override { return name; }
+    std::string getType() const override { return "Potion"; }
+    int getHealAmount() const { return healAmount; }
+    int getPower() const override { return healAmount; }
+
+    void saveToFile(std::ostream& out) const override {
+        writeInt(out, static_cast<int32_t>(ItemTag::Potion));
+        writeString(out, name.view());
+        writeInt(out, healAmount);
+    }
+
+private:
+    symbols::Symbol name;
+    int healAmount;
+};
+
+// Реестр описаний предметов. Каждое имя регистрируется один раз,
+// все инвентари ссылаются на описание по его номеру.
+// Реестр общий для всех потоков: добавление идёт под исключительной блокировкой, поиск по имени -
+// под разделяемой, а get() по номеру обходится без блокировки
+class ItemRegistry {
+private:
+    // Указатели на описания лежат в блоках по blockSize штук. Блоки не перемещаются,
+    // а номер описания попадает к читателю только после того, как указатель записан
+    static constexpr unsigned blockBits = 10;
+    static constexpr uint32_t blockSize = 1u << blockBits;
+    static constexpr uint32_t maxBlocks = 4096;
+
+    mutable std::shared_mutex mutex;
+    std::vector<std::unique_ptr<const Item>> definitions;
+    std::atomic<const Item**> blocks[maxBlocks] = {};
+    // Ключи - строки из таблицы символов: они живут до конца программы и не копируются.
+    // Поиск по имени обходится без блокировок таблицы
+    std::unordered_map<std::string_view, uint32_t> ids;
+
+public:
+    ItemRegistry() = default;
+    ItemRegistry(const ItemRegistry&) = delete;
+    ItemRegistry& operator=(const ItemRegistry&) = delete;
+
+    ~ItemRegistry() {
+        for (auto& block : blocks) {
+            delete[] block.load(std::memory_order_relaxed);
+        }
+    }
+
+    static ItemRegistry& instance() {
+        static ItemRegistry registry;
+        return registry;
+    }
+
+    // Номер описания; если предмет с таким именем уже есть, используется существующее описание.
+    // Другой тип или другая сила под тем же именем - ошибка, а не молчаливая подмена характеристик
+    uint32_t intern(std::unique_ptr<const Item> item) {
+        std::unique_lock<std::shared_mutex> lock(mutex);
+        auto inserted = ids.emplace(item->getNameSymbol().view(), static_cast<uint32_t>(definitions.size()));
+        if (!inserted.second) {
+            const Item& existing = *definitions[inserted.first->second];
+            if (existing.getType() != item->getType() || existing.getPower() != item->getPower()) {
+                throw std::invalid_argument("Item " + std::string(item->getName()) + " is already registered with different stats");
+            }
+            return inserted.first->second;
+        }
+
+        uint32_t id = inserted.first->second;
+        try {
+            if (id >= maxBlocks * blockSize) {
+                throw std::length_error("Item registry is full");
+            }
+            std::atomic<const Item**>& block = blocks[id >> blockBits];
+            if (!block.load(std::memory_order_relaxed)) {
+                block.store(new const Item*[blockSize], std::memory_order_release);
+            }
+            definitions.push_back(std::move(item));
+        }
+        catch (...) {
+            ids.erase(inserted.first);
+            throw;
+        }
+        blocks[id >> blockBits].load(std::memory_order_relaxed)[id & (blockSize - 1)] = definitions.back().get();
+        return id;
+    }
+
+    bool find(std::string_view name, uint32_t& id) const {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        auto it = ids.find(name);
+        if (it == ids.end()) {
+            return false;
+        }
+        id = it->second;
+        return true;
+    }
+
+    const Item& get(uint32_t id) const {
+        return *blocks[id >> blockBits].load(std::memory_order_acquire)[id & (blockSize - 1)];
+    }
+};
+
+// Экземпляр предмета в инвентаре: номер описания и собственное состояние
+struct ItemInstance {
+    uint32_t definition;
+    int32_t count;
+    int32_t durability; // Прочность каждого предмета стопки
+    uint32_t next;      // Следующая стопка того же предмета (с другой прочностью)
+};
+
+// Класс инвентаря.
+// Экземпляры одного предмета с одинаковой прочностью складываются в одну стопку, стопки лежат
+// подряд в массиве. Стопки одного предмета с разной прочностью связаны списком через next,
+// индекс по номеру описания указывает на первую из них. Поиск по имени идёт через ItemRegistry
+// и индекс, пустая стопка удаляется перестановкой последней на её место, поэтому операции
+// выполняются за O(1) плюс число стопок этого предмета (обычно одна)
+class Inventory {
+public:
+    static constexpr uint32_t npos = UINT32_MAX;
+
+    // Память всех инвентарей учитывается в подсистеме "lb9.inventory"
+    using StackList = std::vector<ItemInstance, memstats::CountingAllocator<ItemInstance>>;
+    using StackIndex = std::unordered_map<uint32_t, uint32_t, std::hash<uint32_t>, std::equal_to<uint32_t>,
+        memstats::CountingAllocator<std::pair<const uint32_t, uint32_t>>>;
+
+private:
+    StackList stacks;
+    StackIndex index; // Номер описания -> позиция первой стопки предмета в stacks
+
+    static memstats::AllocationStats& memory() {
+        static memstats::AllocationStats& stats = memstats::subsystem("lb9.inventory");
+        return stats;
+    }
+
+    // Первая стопка предмета
+    ItemInstance& findStack(std::string_view itemName) {
+        uint32_t id;
+        if (ItemRegistry::instance().find(itemName, id)) {
+            auto it = index.find(id);
+            if (it != index.end()) {
+                return stacks[it->second];
+            }
+        }
+        throw std::runtime_error("Item not found: " + std::string(itemName));
+    }
+
+    // Ссылка на стопку pos: запись индекса или поле next предыдущей стопки того же предмета
+    uint32_t& linkTo(uint32_t pos) {
+        uint32_t* link = &index.find(stacks[pos].definition)->second;
+        while (*link != pos) {
+            link = &stacks[*link].next;
+        }
+        return *link;
+    }
+
+    // Снимает один предмет со стопки и удаляет её, если она опустела
+    void takeOne(ItemInstance& stack) {
+        if (--stack.count > 0) {
+            return;
+        }
+
+        // Стопка исключается из списка своего предмета, последняя стопка переезжает на её место
+        uint32_t pos = static_cast<uint32_t>(&stack - stacks.data());
+        auto head = index.find(stack.definition);
+        if (head->second == pos && stack.next == npos) {
+            index.erase(head);
+        }
+        else {
+            linkTo(pos) = stack.next;
+        }
+
+        uint32_t last = static_cast<uint32_t>(stacks.size() - 1);
+        if (pos != last) {
+            linkTo(last) = pos;
+            stacks[pos] = stacks[last];
+        }
+        stacks.pop_back();
+    }
+
+public:
+    Inventory()
+        : stacks(StackList::allocator_type(memory())), index(StackIndex::allocator_type(memory())) {
+    }
+
+    void addItem(uint32_t definition, int count = 1) {
+        addItem(definition, count, ItemRegistry::instance().get(definition).getMaxDurability());
+    }
+
+    // Предметы с той же прочностью добавляются в её стопку, с другой - в новую стопку
+    void addItem(uint32_t definition, int count, int durability) {
+        TRACE_SCOPE("Inventory::addItem");
+        if (count <= 0) {
+            throw std::invalid_argument("Item count must be positive");
+        }
+        if (stacks.size() >= npos) {
+            throw std::length_error("Inventory is full");
+        }
+
+        uint32_t pos = static_cast<uint32_t>(stacks.size());
+        auto inserted = index.emplace(definition, pos);
+        if (!inserted.second) {
+            for (uint32_t i = inserted.first->second; i != npos; i = stacks[i].next) {
+                if (stacks[i].durability == durability) {
+                    stacks[i].count += count;
+                    return;
+                }
+            }
+            // Новая стопка становится первой в списке предмета
+            stacks.push_back({ definition, count, durability, inserted.first->second });
+            inserted.first->second = pos;
+            return;
+        }
+        try {
+            stacks.push_back({ definition, count, durability, npos });
+        }
+        catch (...) {
+            index.erase(inserted.first);
+            throw;
+        }
+    }
+
+    void addItem(std::unique_ptr<Item> item, int count = 1) {
+        addItem(ItemRegistry::instance().intern(std::move(item)), count);
+    }
+
+    void dropItem(std::string_view itemName) {
+        takeOne(findStack(itemName));
+        std::cout << "Dropped: " << itemName << std::endl;
+    }
+
+    void useItem(std::string_view itemName, Entity& target) {
+        TRACE_SCOPE("Inventory::useItem");
+        ItemInstance& stack = findStack(itemName);
+        ItemRegistry::instance().get(stack.definition).use(target);
+        takeOne(stack);
+        TRACE_COUNTER("Inventory::stacks", stacks.size());
+    }
+
+    void writeItems(text::Buffer& out) const {
+        out << "Inventory:\n";
+        for (const auto& stack : stacks) {
+            const Item& item = ItemRegistry::instance().get(stack.definition);
+            out << "- " << item.getName() << " (" << item.getType() << ")";
+            if (stack.durability != item.getMaxDurability()) {
+                out << " durability " << stack.durability << "/" << item.getMaxDurability();
+            }
+            if (stack.count > 1) {
+                out << " x" << stack.count;
+            }
+            out << '\n';
+        }
+    }
+
+    void showItems() const {
+        text::Buffer out;
+        writeItems(out);
+        out.flushTo(std::cout);
+    }
+
+    bool hasItem(std::string_view itemName) const {
+        uint32_t id;
+        return ItemRegistry::instance().find(itemName, id) && index.count(id) != 0;
+    }
+
+    int countOf(std::string_view itemName) const {
+        uint32_t id;
+        if (!ItemRegistry::instance().find(itemName, id)) {
+            return 0;
+        }
+        int total = 0;
+        auto it = index.find(id);
+        for (uint32_t i = it != index.end() ? it->second : npos; i != npos; i = stacks[i].next) {
+            total += stacks[i].count;
+        }
+        return total;
+    }
+
+    const StackList& getStacks() const {
+        return stacks;
+    }
+};
+
+// Кривая опыта: таблица стоимости каждого следующего уровня, после конца таблицы
+// каждый уровень стоит столько же, сколько последний в ней.
+// Уровень по суммарному опыту находится двоичным поиском по накопленным суммам таблицы
+// или делением за её пределами, поэтому время не зависит от числа полученных уровней
+class LevelCurve {
+public:
+    // Выше этого уровня опыт уже не поднимает
+    static constexpr int maxLevel = INT32_MAX;
+
+    explicit LevelCurve(const std::vector<int>& stepCosts) {
+        if (stepCosts.empty()) {
+            throw std::invalid_argument("Level curve must not be empty");
+        }
+        cumulative.push_back(0);
+        for (int cost : stepCosts) {
+            if (cost <= 0) {
+                throw std::invalid_argument("Level cost must be positive");
+            }
+            cumulative.push_back(cumulative.back() + cost);
+        }
+        lastCost = stepCosts.back();
+    }
+
+    // Каждый уровень стоит 100 опыта
+    static const LevelCurve& standard() {
+        static const LevelCurve curve({ 100 });
+        return curve;
+    }
+
+    // Суммарный опыт, нужный для достижения уровня level с первого
+    int64_t totalFor(int level) const {
+        size_t steps = static_cast<size_t>(std::max(level, 1) - 1);
+        if (steps < cumulative.size()) {
+            return cumulative[steps];
+        }
+        return cumulative.back() + static_cast<int64_t>(steps - (cumulative.size() - 1)) * lastCost;
+    }
+
+    // Уровень, достигнутый с суммарным опытом total
+    int levelFor(int64_t total) const {
+        if (total >= cumulative.back()) {
+            int64_t level = static_cast<int64_t>(cumulative.size()) + (total - cumulative.back()) / lastCost;
+            return static_cast<int>(std::min<int64_t>(level, maxLevel));
+        }
+        return static_cast<int>(std::upper_bound(cumulative.begin(), cumulative.end(), total) - cumulative.begin());
+    }
+
+    // Опыт, нужный для перехода с уровня level на следующий
+    int64_t costOf(int level) const {
+        return totalFor(level + 1) - totalFor(level);
+    }
+
+private:
+    std::vector<int64_t> cumulative; // cumulative[i] - опыт, нужный для уровня i + 1
+    int64_t lastCost;
+};
+
+// Класс персонажа
+class Character : public Entity {
+private:
+    int level;
+    int experience;
+    Inventory inventory;
+
+public:
+    Character(const std::string& n, int h, int a, int d)
+        : Entity(n, h, a, d), level(1), experience(0) {
+    }
+
+    // Восстановление сохранённого персонажа без повторного набора уровней
+    Character(const std::string& n, int h, int maxH, int a, int d, int lvl, int exp)
+        : Entity(n, maxH, a, d), level(lvl), experience(exp) {
+        health = h;
+    }
+
+    void heal(int amount, Logger<std::string>& logger) {
+        int oldHealth = health;
+        Entity::heal(amount);
+        int healed = health - oldHealth;
+        std::pmr::string msg(arena::resource());
+        msg.append(name.view()).append(" heals for ").append(std::to_string(healed)).append(" HP!");
+        logger.log(msg);
+    }
+
+    void gainExperience(int exp, Logger<std::string>& logger) {
+        if (addExperience(exp) > 0) {
+            std::pmr::string msg(arena::resource());
+            msg.append(name.view()).append(" leveled up to level ").append(std::to_string(level)).append("!");
+            logger.log(msg);
+        }
+    }
+
+    // Начисление опыта без записи в лог; за раз можно получить любое число уровней.
+    // Возвращает число полученных уровней
+    int addExperience(int exp) {
+        if (exp < 0) {
+            throw std::invalid_argument("Experience cannot be negative");
+        }
+
+        const LevelCurve& curve = LevelCurve::standard();
+        int64_t total = curve.totalFor(level) + experience + exp;
+        int newLevel = curve.levelFor(total);
+        int gained = newLevel - level;
+        experience = static_cast<int>(total - curve.totalFor(newLevel));
+        if (gained > 0) {
+            level = newLevel;
+            attack += 2 * gained;
+            defense += gained;
+            maxHealth += 10 * gained;
+            health = maxHealth;
+        }
+        return gained;
+    }
+
+    void addItem(std::unique_ptr<Item> item, int count = 1) {
+        inventory.addItem(std::move(item), count);
+    }
+
+    void addItem(uint32_t definition, int count, int durability) {
+        inventory.addItem(definition, count, durability);
+    }
+
+    void dropItem(std::string_view item) {
+        inventory.dropItem(item);
+    }
+
+    void useItem(std::string_view item) {
+        inventory.useItem(item, *this);
+    }
+
+    void showInventory() const {
+        inventory.showItems();
+    }
+
+    const Inventory& getInventory() const {
+        return inventory;
+    }
+
+    int getLevel() const { return level; }
+    int getExperience() const { return experience; }
+};
+
+// Итог массового начисления опыта
+struct ExperienceReport {
+    size_t characters = 0;
+    size_t leveledUp = 0;     // Сколько персонажей получили хотя бы один уровень
+    int64_t levelsGained = 0;
+    int highestLevel = 0;
+};
+
+// Начисляет amounts[i] опыта персонажу characters[i]. Список делится на части по потокам,
+// поэтому каждый персонаж должен встречаться в нём один раз.
+// Вместо записи о каждом повышении уровня в лог пишется одна запись на весь список
+ExperienceReport awardExperience(const std::vector<Character*>& characters, const std::vector<int>& amounts,
+    Logger<std::string>& logger, unsigned threadCount = std::thread::hardware_concurrency()) {
+    if (characters.size() != amounts.size()) {
+        throw std::invalid_argument("Each character needs an experience amount");
+    }
+    // Проверка до начисления: ошибка не должна оставить список начисленным наполовину
+    if (std::any_of(amounts.begin(), amounts.end(), [](int amount) { return amount < 0; })) {
+        throw std::invalid_argument("Experience cannot be negative");
+    }
+
+    // Маленькие части быстрее обработать в одном потоке, чем запускать новые
+    const size_t minPart = 4096;
+    size_t parts = std::max<size_t>(1, std::min<size_t>(std::max(1u, threadCount), characters.size() / minPart));
+    size_t partSize = (characters.size() + parts - 1) / parts;
+    std::vector<ExperienceReport> reports(parts);
+
+    auto award = [&characters, &amounts, &reports](size_t part, size_t begin, size_t end) {
+        ExperienceReport report;
+        report.characters = end - begin;
+        for (size_t i = begin; i < end; ++i) {
+            int gained = characters[i]->addExperience(amounts[i]);
+            report.levelsGained += gained;
+            report.leveledUp += gained > 0;
+            report.highestLevel = std::max(report.highestLevel, characters[i]->getLevel());
+        }
+        reports[part] = report;
+    };
+
+    std::vector<std::thread> threads;
+    for (size_t part = 1; part < parts; ++part) {
+        threads.emplace_back(award, part, part * partSize, std::min(characters.size(), (part + 1) * partSize));
+    }
+    award(0, 0, std::min(characters.size(), partSize));
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    ExperienceReport total;
+    for (const auto& report : reports) {
+        total.characters += report.characters;
+        total.leveledUp += report.leveledUp;
+        total.levelsGained += report.levelsGained;
+        total.highestLevel = std::max(total.highestLevel, report.highestLevel);
+    }
+    logger.log("Experience awarded to " + std::to_string(total.characters) + " characters: "
+        + std::to_string(total.leveledUp) + " leveled up, " + std::to_string(total.levelsGained)
+        + " levels gained, highest level " + std::to_string(total.highestLevel));
+    return total;
+}
+
+// Класс монстра
+class Monster : public Entity {
+public:
+    Monster(const std::string& n, int h, int a, int d) : Entity(n, h, a, d) {}
+};
+
+// Производные классы монстров
+class Goblin : public Monster {
+public:
+    Goblin() : Monster("Goblin", 30, 10, 2) {}
+};
+
+class Dragon : public Monster {
+public:
+    Dragon() : Monster("Dragon", 150, 40, 10) {}
+};
+
+// Класс скелета с сопротивлением
+class Skeleton : public Monster {
+public:
+    Skeleton(const std::string& name, int health, int attack, int defense, bool isResistant = true)
+        : Monster(name, health, attack, defense), isResistant(isResistant) {
+    }
+
+    void takeDamage(int damage) override {
+        if (isResistant) {
+            std::cout << name << " resists some damage!\n";
+        }
+        Monster::takeDamage(absorbDamage(damage));
+    }
+
+    int absorbDamage(int damage) const override {
+        return isResistant ? damage / 2 : damage;
+    }
+
+private:
+    bool isResistant;
+};
+
+// Класс игры с улучшенной системой сохранения.
+// Формат файла: "LB9S", версия, характеристики персонажа, число предметов,
+// затем каждая стопка предметов: количество, прочность, метка типа, имя, параметр предмета
+class Game {
+public:
+    void saveGame(const Character& character, const std::string& filename = "savegame.dat") {
+        TRACE_SCOPE("Game::saveGame");
+        std::ofstream file(filename, std::ios::binary);
+        if (!file) {
+            throw std::runtime_error("Failed to open save file");
+        }
+
+        file.write(saveMagic, sizeof(saveMagic));
+        writeInt(file, saveVersion);
+        writeString(file, character.getName());
+        writeInt(file, character.getHealth());
+        writeInt(file, character.getMaxHealth());
+        writeInt(file, character.getAttack());
+        writeInt(file, character.getDefense());
+        writeInt(file, character.getLevel());
+        writeInt(file, character.getExperience());
+
+        const auto& stacks = character.getInventory().getStacks();
+        writeInt(file, static_cast<int32_t>(stacks.size()));
+        for (const auto& stack : stacks) {
+            writeInt(file, stack.count);
+            writeInt(file, stack.durability);
+            ItemRegistry::instance().get(stack.definition).saveToFile(file);
+        }
+
+        if (!file) {
+            throw std::runtime_error("Failed to write save file");
+        }
+    }
+
+    Character loadGame(const std::string& filename = "savegame.dat") {
+        TRACE_SCOPE("Game::loadGame");
+        std::ifstream file(filename, std::ios::binary);
+        if (!file) {
+            throw std::runtime_error("Failed to open save file");
+        }
+
+        char magic[sizeof(saveMagic)];
+        if (!file.read(magic, sizeof(magic)) || !std::equal(magic, magic + sizeof(magic), saveMagic)) {
+            throw std::runtime_error("Not a save file");
+        }
+        if (readInt(file) != saveVersion) {
+            throw std::runtime_error("Unsupported save version");
+        }
+
+        std::string name = readString(file);
+        int health = readInt(file);
+        int maxHealth = readInt(file);
+        int attack = readInt(file);
+        int defense = readInt(file);
+        int level = readInt(file);
+        int experience = readInt(file);
+        // Персонажа с такими значениями игра создать не может, значит файл повреждён
+        if (maxHealth <= 0 || health <= 0 || health > maxHealth
+            || level < 1 || level > LevelCurve::maxLevel || experience < 0
+            || (level < LevelCurve::maxLevel && experience >= LevelCurve::standard().costOf(level))) {
+            throw std::runtime_error("Save file is corrupted");
+        }
+        Character character(name, health, maxHealth, attack, defense, level, experience);
+
+        int stackCount = readInt(file);
+        if (stackCount < 0) {
+            throw std::runtime_error("Save file is corrupted");
+        }
+        for (int i = 0; i < stackCount; ++i) {
+            int count = readInt(file);
+            int durability = readInt(file);
+            if (count <= 0) {
+                throw std::runtime_error("Save file is corrupted");
+            }
+            ItemTag tag = static_cast<ItemTag>(readInt(file));
+            std::string itemName = readString(file);
+            int value = readInt(file);
+
+            std::unique_ptr<Item> item;
+            switch (tag) {
+            case ItemTag::Weapon:
+                item = std::make_unique<Weapon>(itemName, value);
+                break;
+            case ItemTag::Potion:
+                item = std::make_unique<Potion>(itemName, value);
+                break;
+            default:
+                throw std::runtime_error("Unknown item type in save file");
+            }
+            character.addItem(ItemRegistry::instance().intern(std::move(item)), count, durability);
+        }
+
+        if (logger) {
+            logger->log("Game loaded: " + std::string(character.getName()));
+        }
+        return character;
+    }
+
+    void setLogger(std::shared_ptr<Logger<std::string>> newLogger) {
+        logger = newLogger;
+    }
+
+private:
+    static constexpr char saveMagic[4] = { 'L', 'B', '9', 'S' };
+    static const int32_t saveVersion = 3;
+
+    std::shared_ptr<Logger<std::string>> logger;
+};
+
+constexpr char Game::saveMagic[4];
+
+// Постоянные потоки для фаз тика World.
+// run() выполняет job(worker) на каждом потоке пула, включая вызывающий (worker 0),
+// и возвращается, когда все потоки закончили; исключение из job передаётся вызывающему
+class WorkerPool {
+public:
+    explicit WorkerPool(unsigned workerCount) {
+        for (unsigned i = 1; i < std::max(1u, workerCount); ++i) {
+            threads.emplace_back([this, i] { loop(i); });
+        }
+    }
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    ~WorkerPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+
+    unsigned size() const { return static_cast<unsigned>(threads.size()) + 1; }
+
+    void run(const std::function<void(unsigned)>& job) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            task = &job;
+            pending = static_cast<unsigned>(threads.size());
+            failure = nullptr;
+            ++generation;
+        }
+        wake.notify_all();
+
+        std::exception_ptr own;
+        try {
+            job(0);
+        }
+        catch (...) {
+            own = std::current_exception();
+        }
+
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [this] { return pending == 0; });
+        task = nullptr;
+        if (own) {
+            std::rethrow_exception(own);
+        }
+        if (failure) {
+            std::rethrow_exception(failure);
+        }
+    }
+
+private:
+    void loop(unsigned worker) {
+        uint64_t seen = 0;
+        for (;;) {
+            const std::function<void(unsigned)>* job;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [this, seen] { return stopping || generation != seen; });
+                if (stopping) {
+                    return;
+                }
+                seen = generation;
+                job = task;
+            }
+
+            std::exception_ptr error;
+            try {
+                (*job)(worker);
+            }
+            catch (...) {
+                error = std::current_exception();
+            }
+
+            std::lock_guard<std::mutex> lock(mutex);
+            if (error && !failure) {
+                failure = error;
+            }
+            if (--pending == 0) {
+                done.notify_one();
+            }
+        }
+    }
+
+    std::vector<std::thread> threads;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    const std::function<void(unsigned)>* task = nullptr;
+    uint64_t generation = 0;
+    unsigned pending = 0;
+    bool stopping = false;
+    std::exception_ptr failure;
+};
+
+enum class FightOutcome { CharacterWon, MonsterWon, Draw };
+
+struct FightResult {
+    uint64_t tick;
+    size_t character;
+    size_t monster;
+    FightOutcome outcome;
+};
+
+// Длительность тиков World: перцентили по всем тикам и число тиков, не уложившихся в шаг
+struct TickStats {
+    size_t ticks = 0;
+    size_t overruns = 0;
+    std::chrono::nanoseconds p50{ 0 };
+    std::chrono::nanoseconds p90{ 0 };
+    std::chrono::nanoseconds p99{ 0 };
+    std::chrono::nanoseconds max{ 0 };
+};
+
+// Мир с фиксированным шагом времени: владеет персонажами и монстрами, которые сражаются парами
+// (каждое существо участвует не больше чем в одном бою).
+// Тик выполняется в две фазы. Сначала бои делятся на непрерывные части по потокам пула,
+// и для каждого боя по неизменному состоянию участников считается урон обоих ударов.
+// Затем в одном потоке урон применяется в порядке боёв, а завершённые бои убираются.
+// Поэтому результат не зависит от числа потоков. Удары в тике одновременные и считаются
+// по правилам attackEnemy, но без вывода на консоль и в лог
+class World {
+public:
+    explicit World(unsigned threadCount = std::thread::hardware_concurrency(),
+        std::chrono::nanoseconds tickLength = std::chrono::milliseconds(50))
+        : pool(threadCount), tickLength(tickLength) {
+    }
+
+    size_t addCharacter(std::unique_ptr<Character> character) {
+        characters.push_back(std::move(character));
+        characterBusy.push_back(false);
+        return characters.size() - 1;
+    }
+
+    size_t addMonster(std::unique_ptr<Monster> monster) {
+        monsters.push_back(std::move(monster));
+        monsterBusy.push_back(false);
+        return monsters.size() - 1;
+    }
+
+    void startEncounter(size_t character, size_t monster) {
+        if (character >= characters.size() || monster >= monsters.size()) {
+            throw std::out_of_range("No such combatant");
+        }
+        if (characterBusy[character] || monsterBusy[monster]) {
+            throw std::invalid_argument("Combatant is already fighting");
+        }
+        if (characters[character]->getHealth() == 0 || monsters[monster]->getHealth() == 0) {
+            throw std::invalid_argument("Combatant is already defeated");
+        }
+        characterBusy[character] = true;
+        monsterBusy[monster] = true;
+        encounters.push_back({ character, monster });
+    }
+
+    void tick() {
+        TRACE_SCOPE("World::tick");
+        auto start = std::chrono::steady_clock::now();
+
+        strikes.resize(encounters.size());
+        if (encounters.size() < parallelThreshold) {
+            computeStrikes(0, encounters.size());
+        }
+        else {
+            size_t part = (encounters.size() + pool.size() - 1) / pool.size();
+            pool.run([this, part](unsigned worker) {
+                size_t begin = std::min(encounters.size(), worker * part);
+                computeStrikes(begin, std::min(encounters.size(), begin + part));
+            });
+        }
+        applyStrikes();
+
+        ++tickNumber;
+        tickTimes.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count());
+    }
+
+    // Тики идут с шагом tickLength; если тик не уложился в шаг, следующий начинается сразу
+    void run(size_t ticks) {
+        auto next = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < ticks; ++i) {
+            tick();
+            next += tickLength;
+            auto now = std::chrono::steady_clock::now();
+            if (now < next) {
+                std::this_thread::sleep_until(next);
+            }
+            else {
+                ++overruns;
+                next = now;
+            }
+        }
+    }
+
+    TickStats getTickStats() const {
+        TickStats stats;
+        stats.ticks = tickTimes.size();
+        stats.overruns = overruns;
+        if (tickTimes.empty()) {
+            return stats;
+        }
+
+        std::vector<int64_t> sorted(tickTimes);
+        std::sort(sorted.begin(), sorted.end());
+        auto percentile = [&sorted](size_t p) {
+            return std::chrono::nanoseconds(sorted[std::min(sorted.size() - 1, sorted.size() * p / 100)]);
+        };
+        stats.p50 = percentile(50);
+        stats.p90 = percentile(90);
+        stats.p99 = percentile(99);
+        stats.max = std::chrono::nanoseconds(sorted.back());
+        return stats;
+    }
+
+    // Бои, завершившиеся с прошлого вызова, в порядке завершения
+    std::vector<FightResult> takeFinished() {
+        std::vector<FightResult> result;
+        result.swap(finished);
+        return result;
+    }
+
+    size_t activeEncounters() const { return encounters.size(); }
+    uint64_t getTickNumber() const { return tickNumber; }
+    const Character& getCharacter(size_t index) const { return *characters.at(index); }
+    const Monster& getMonster(size_t index) const { return *monsters.at(index); }
+
+private:
+    struct Encounter {
+        size_t character;
+        size_t monster;
+    };
+
+    struct Strikes {
+        int toMonster;
+        int toCharacter;
+    };
+
+    // Меньше боёв считается в вызывающем потоке: пробуждение пула дороже самой работы
+    static const size_t parallelThreshold = 4096;
+
+    static int strikeDamage(const Entity& attacker, const Entity& target) {
+        int damage = attacker.getAttack() - target.getDefense();
+        return damage > 0 ? target.absorbDamage(damage) : 0;
+    }
+
+    void computeStrikes(size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            const Character& character = *characters[encounters[i].character];
+            const Monster& monster = *monsters[encounters[i].monster];
+            strikes[i] = { strikeDamage(character, monster), strikeDamage(monster, character) };
+        }
+    }
+
+    void applyStrikes() {
+        size_t kept = 0;
+        for (size_t i = 0; i < encounters.size(); ++i) {
+            Encounter encounter = encounters[i];
+            bool monsterDefeated = monsters[encounter.monster]->applyDamage(strikes[i].toMonster);
+            bool characterDefeated = characters[encounter.character]->applyDamage(strikes[i].toCharacter);
+
+            if (!monsterDefeated && !characterDefeated) {
+                encounters[kept++] = encounter;
+                continue;
+            }
+            FightOutcome outcome = !characterDefeated ? FightOutcome::CharacterWon
+                : !monsterDefeated ? FightOutcome::MonsterWon : FightOutcome::Draw;
+            finished.push_back({ tickNumber, encounter.character, encounter.monster, outcome });
+            characterBusy[encounter.character] = false;
+            monsterBusy[encounter.monster] = false;
+        }
+        encounters.resize(kept);
+    }
+
+    WorkerPool pool;
+    std::chrono::nanoseconds tickLength;
+    std::vector<std::unique_ptr<Character>> characters;
+    std::vector<std::unique_ptr<Monster>> monsters;
+    std::vector<bool> characterBusy;
+    std::vector<bool> monsterBusy;
+    std::vector<Encounter> encounters;
+    std::vector<Strikes> strikes;
+    std::vector<FightResult> finished;
+    std::vector<int64_t> tickTimes; // Длительность каждого тика в наносекундах
+    size_t overruns = 0;
+    uint64_t tickNumber = 0;
+};
+
+// Без main файл можно подключить к бенчмаркам (см. bench/)
+#ifndef LB_NO_MAIN
+int main() {
+    try {
+        // Инициализация логгера
+        auto logger = std::make_shared<Logger<std::string>>("game_log.txt");
+        logger->log("=== Game session started ===");
+
+        // Инициализация игровых объектов
+        Game game;
+        game.setLogger(logger);
+
+        // Арена для сообщений боя: память берётся из неё на время боя и сбрасывается после него
+        memstats::CountingResource arenaMemory(memstats::subsystem("lb9.arena"));
+        arena::Arena combatArena(arena::Arena::defaultChunkSize, &arenaMemory);
+
+        // Создание персонажа
+        Character hero("Sir Lancelot", 120, 25, 15);
+        logger->log("Player created: " + std::string(hero.getName()));
+
+        // Создание монстров
+        Skeleton skeleton1("Bony", 60, 12, 8, true);
+        Skeleton skeleton2("Rusty", 55, 10, 7);
+        Dragon dragon;
+        logger->log("Enemies spawned: " + std::string(skeleton1.getName()) + ", "
+            + std::string(skeleton2.getName()) + ", " + std::string(dragon.getName()));
+
+        // Добавление предметов в инвентарь
+        hero.addItem(std::make_unique<Weapon>("Excalibur", 35));
+        hero.addItem(std::make_unique<Weapon>("Steel Dagger", 15));
+        hero.addItem(std::make_unique<Potion>("Health Elixir", 50), 3);
+        hero.addItem(std::make_unique<Potion>("Mana Potion", 30));
+        // Подобранный изношенный кинжал лежит отдельной стопкой и сохраняет свою прочность
+        hero.addItem(ItemRegistry::instance().intern(std::make_unique<Weapon>("Steel Dagger", 15)), 1, 40);
+        logger->log("Items added to inventory");
+
+        // Демонстрация инвентаря
+        std::cout << "\n=== Initial Hero State ===\n";
+        hero.displayInfo();
+        std::cout << "Inventory:\n";
+        hero.showInventory();
+
+        // Бой со скелетом 1
+        std::cout << "\n=== Battle with " << skeleton1.getName() << " ===\n";
+        {
+            arena::Scope battle(combatArena);
+            hero.attackEnemy(skeleton1, *logger);
+            skeleton1.attackEnemy(hero, *logger);
+            hero.attackEnemy(skeleton1, *logger);
+        }
+
+        // Использование зелья
+        std::cout << "\n=== Using Health Potion ===\n";
+        hero.useItem("Health Elixir");
+        hero.showInventory();
+
+        // Бой со скелетом 2
+        std::cout << "\n=== Battle with " << skeleton2.getName() << " ===\n";
+        {
+            arena::Scope battle(combatArena);
+            hero.attackEnemy(skeleton2, *logger);
+            skeleton2.attackEnemy(hero, *logger);
+            hero.attackEnemy(skeleton2, *logger);
+        }
+
+        // Получение опыта
+        std::cout << "\n=== Gaining Experience ===\n";
+        hero.gainExperience(75, *logger);
+        hero.gainExperience(50, *logger); // Должен повысить уровень
+        hero.displayInfo();
+
+        // Бой с драконом
+        std::cout << "\n=== Epic Battle with " << dragon.getName() << " ===\n";
+        {
+            arena::Scope battle(combatArena);
+            for (int i = 0; i < 3; ++i) {
+                hero.attackEnemy(dragon, *logger);
+                dragon.attackEnemy(hero, *logger);
+            }
+        }
+
+        // Сохранение игры
+        std::cout << "\n=== Saving Game ===\n";
+        game.saveGame(hero, "hero_save.dat");
+        logger->log("Game saved");
+
+        // Загрузка игры
+        std::cout << "\n=== Loading Game ===\n";
+        Character loadedHero = game.loadGame("hero_save.dat");
+        loadedHero.displayInfo();
+        loadedHero.showInventory();
+
+        // Демонстрация обработки исключений
+        std::cout << "\n=== Exception Handling Demo ===\n";
+        try {
+            loadedHero.useItem("Nonexistent Item");
+        }
+        catch (const std::exception& e) {
+            std::cout << "Error: " << e.what() << std::endl;
+            logger->log(std::string("Exception: ") + e.what());
+        }
+
+        // Создание нового персонажа и демонстрация инвентаря
+        std::cout << "\n=== New Character Demo ===\n";
+        Character mage("Gandalf", 80, 15, 10);
+        mage.addItem(std::make_unique<Potion>("Mega Potion", 100));
+        mage.addItem(std::make_unique<Weapon>("Magic Staff", 20));
+        mage.displayInfo();
+        mage.showInventory();
+
+        // Награда за рейд: опыт начисляется всем участникам сразу, в лог пишется одна запись
+        std::cout << "\n=== Raid Reward ===\n";
+        std::vector<std::unique_ptr<Character>> raid;
+        std::vector<Character*> raiders;
+        std::vector<int> rewards;
+        for (int i = 0; i < 100000; ++i) {
+            raid.push_back(std::make_unique<Character>("Raider " + std::to_string(i), 100, 10, 5));
+            raiders.push_back(raid.back().get());
+            rewards.push_back(75 * (i % 8));
+        }
+        ExperienceReport reward = awardExperience(raiders, rewards, *logger);
+        std::cout << "Raiders leveled up: " << reward.leveledUp << " of " << reward.characters
+            << ", levels gained: " << reward.levelsGained << ", highest level: " << reward.highestLevel << "\n";
+
+        // Массовые бои в мире с фиксированным шагом 20 тиков в секунду
+        std::cout << "\n=== World Simulation ===\n";
+        World world;
+        for (int i = 0; i < 20000; ++i) {
+            size_t knight = world.addCharacter(std::make_unique<Character>("Knight " + std::to_string(i), 120, 25, 15));
+            size_t bones = world.addMonster(std::make_unique<Skeleton>("Skeleton " + std::to_string(i), 60, 12, 8, i % 2 == 0));
+            world.startEncounter(knight, bones);
+        }
+        while (world.activeEncounters() > 0) {
+            world.run(1);
+        }
+        size_t knightWins = 0;
+        for (const auto& result : world.takeFinished()) {
+            knightWins += result.outcome == FightOutcome::CharacterWon;
+        }
+        TickStats ticks = world.getTickStats();
+        std::cout << "Fights won by knights: " << knightWins << " in " << ticks.ticks << " ticks\n"
+            << "Tick time p50/p90/p99/max, us: " << ticks.p50.count() / 1000 << "/" << ticks.p90.count() / 1000
+            << "/" << ticks.p99.count() / 1000 << "/" << ticks.max.count() / 1000
+            << ", overruns: " << ticks.overruns << "\n";
+
+        std::cout << "\n=== Memory Usage ===\n";
+        memstats::report(std::cout);
+
+        logger->log("=== Game session ended ===\n");
+        TRACE_DUMP("lb9_trace");
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Fatal Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
+#endif // LB_NO_MAIN
\ No newline at end of file